@@ -1,8 +1,16 @@
 #include "AnimateComponent.h"
 #include "Engine.h"
 #include "BodyComponent.h"
-#include "ImageDevice.h"
-#include <iostream>
+#include <cmath>
+#include <cstdlib>
+
+static const std::string EMPTY_NAME;
+
+AnimateComponent::AnimateComponent(ClipId clip)
+    : startTime(Engine::E->getAnimationTime()),
+      clip(clip)
+{
+}
 
 AnimateComponent::AnimateComponent(const std::string& textureName,
                                    int frameCount,
@@ -10,191 +18,120 @@ AnimateComponent::AnimateComponent(const std::string& textureName,
                                    int frameWidth,
                                    int frameHeight,
                                    int frameSpacing)
-    : textureName(textureName),
-      frameCount(frameCount),
-      frameWidth(frameWidth),
-      frameHeight(frameHeight),
-      frameSpacing(frameSpacing),
-      frameTimer(frameTime, true)  // Initialize timer with frameTime and start running
+    : startTime(Engine::E->getAnimationTime()),
+      clip(AnimationLibrary::fromSheet(textureName, frameCount, frameTime, frameWidth, frameHeight, frameSpacing))
 {
-    texture = ImageDevice::get(textureName);
-
-    // If no width/height provided, auto-detect from texture
-    if ((frameWidth == 0 || frameHeight == 0) && texture != nullptr) {
-        int texW, texH;
-        if (SDL_QueryTexture(texture, NULL, NULL, &texW, &texH) == 0) {
-            // Account for spacing: totalWidth = (frameWidth * frameCount) + (spacing * (frameCount - 1))
-            // So: frameWidth = (texW - spacing * (frameCount - 1)) / frameCount
-            if (frameSpacing > 0) {
-                this->frameWidth = (texW - frameSpacing * (frameCount - 1)) / frameCount;
-            } else {
-                this->frameWidth = texW / frameCount;
-            }
-            this->frameHeight = texH;
-            std::cout << "AnimateComponent: Auto-detected frame size for '" << textureName 
-                      << "': " << this->frameWidth << "x" << this->frameHeight 
-                      << " (total: " << texW << "x" << texH << ", frames: " << frameCount 
-                      << ", spacing: " << frameSpacing << ")\n";
-        } else {
-            std::cerr << "AnimateComponent: Failed to query texture dimensions for '" << textureName << "'\n";
-        }
-    } else if (texture == nullptr) {
-        std::cerr << "AnimateComponent: Texture '" << textureName << "' not found!\n";
-    }
 }
 
-void AnimateComponent::update(float dt) {
-    if (!isEnabled) {
-        // Don't update if disabled
-        return;
-    }
-    if (!texture) return; // Can't animate without texture
-    
-    // If frameCount is 1 or 0, this is a single-frame image, don't animate
-    if (frameCount <= 1) return;
-    
-    // Ensure timer is running
-    if (!frameTimer.running()) {
-        frameTimer.start();
-    }
-    
-    // Update timer and check if it has expired
-    if (frameTimer.update(dt)) {
-        // Timer expired - advance to next frame
-        int oldFrame = currentFrame;
-        currentFrame = (currentFrame + 1) % frameCount;
-        
-        // Reset timer for next frame
-        frameTimer.reset();
-        
-        // Debug: print every frame change to see what's happening
-        std::cout << "AnimateComponent '" << textureName << "': frame " << oldFrame 
-                  << " -> " << currentFrame << " (frames: " << frameCount 
-                  << ", enabled: " << isEnabled << ", dt: " << dt << ")\n";
-    }
+double AnimateComponent::clipTime() const {
+    double t = (Engine::E->getAnimationTime() - startTime) * rate + phase;
+    return t > 0.0 ? t : 0.0;
+}
+
+size_t AnimateComponent::getFrame() const {
+    if (!AnimationLibrary::isValid(clip)) return 0;
+
+    const AnimationClip& c = AnimationLibrary::get(clip);
+    size_t frameCount = c.frames.size();
+    if (frameCount <= 1) return 0;
+
+    size_t frame = size_t(clipTime() / c.frameTime);
+    if (c.loop) return frame % frameCount;
+    return frame < frameCount ? frame : frameCount - 1; // hold the last frame
+}
+
+bool AnimateComponent::hasPlayedThrough() const {
+    if (!AnimationLibrary::isValid(clip)) return true;
+
+    const AnimationClip& c = AnimationLibrary::get(clip);
+    if (c.frames.empty()) return true;
+    return clipTime() >= c.frameTime * (c.frames.size() - 1);
+}
+
+// Where a frame's visible part lands when the whole (untrimmed) frame is stretched over rect
+static SDL_FRect placeFrame(const SDL_FRect& rect, const AnimationClip& c, const AnimationFrame& frame, uint8_t flip) {
+    float sx = rect.w / c.frameWidth;
+    float sy = rect.h / c.frameHeight;
+    // Flipping mirrors the margins too
+    int offsetX = (flip & SDL_FLIP_HORIZONTAL) ? c.frameWidth - frame.offset.x - frame.src.w : frame.offset.x;
+    int offsetY = (flip & SDL_FLIP_VERTICAL) ? c.frameHeight - frame.offset.y - frame.src.h : frame.offset.y;
+    return SDL_FRect{rect.x + offsetX * sx, rect.y + offsetY * sy, frame.src.w * sx, frame.src.h * sy};
 }
 
 void AnimateComponent::render() {
-    if (!isEnabled) return; // Don't render if disabled
-    
-    SDL_Renderer* renderer = Engine::E->getRenderer();
-    if (!renderer || !texture) {
-        if (isEnabled) {
-            std::cerr << "AnimateComponent: Cannot render '" << textureName 
-                      << "' - renderer: " << (renderer ? "OK" : "NULL") 
-                      << ", texture: " << (texture ? "OK" : "NULL") << "\n";
-        }
-        return;
-    }
+    if (!isEnabled || !AnimationLibrary::isValid(clip)) return;
 
     BodyComponent* body = getObject()->getComponent<BodyComponent>();
-    if (!body) {
-        if (isEnabled) {
-            std::cerr << "AnimateComponent: No BodyComponent for '" << textureName << "'\n";
-        }
-        return;
-    }
+    if (!body) return;
 
-    // Validate frame dimensions
-    if (frameWidth <= 0 || frameHeight <= 0) {
-        std::cerr << "AnimateComponent: Invalid frame dimensions for '" << textureName 
-                  << "': " << frameWidth << "x" << frameHeight << "\n";
+    // Destination (object's location); off-screen sprites skip frame evaluation entirely
+    const View& view = Engine::E->getView();
+    SDL_Rect dest = view.transform(body->getRect());
+    if (!view.isVisible(dest)) {
+        Engine::E->getRenderQueue().countCulled(RenderLayer::World);
         return;
     }
 
-    // Source (which frame to draw)
-    SDL_Rect src;
-    if (frameCount > 1) {
-        // Sprite sheet - account for spacing between frames
-        // Frame X position = currentFrame * (frameWidth + spacing)
-        int srcX = currentFrame * (frameWidth + frameSpacing);
-        src = {
-            srcX,
-            0,
-            frameWidth,
-            frameHeight
-        };
-        
-        // Debug: print occasionally to verify frame calculation
-        static int renderDebugCounter = 0;
-        if (++renderDebugCounter % 180 == 0) {
-            int texW, texH;
-            SDL_QueryTexture(texture, NULL, NULL, &texW, &texH);
-            std::cout << "AnimateComponent render: texture='" << textureName 
-                      << "', currentFrame=" << currentFrame 
-                      << ", srcX=" << srcX 
-                      << ", frameWidth=" << frameWidth 
-                      << ", spacing=" << frameSpacing
-                      << ", textureSize=" << texW << "x" << texH << "\n";
-        }
-    } else {
-        // Single frame - use full texture
-        int texW, texH;
-        SDL_QueryTexture(texture, NULL, NULL, &texW, &texH);
-        src = { 0, 0, texW, texH };
+    // A clip whose sheet was not resident when it was defined is built on first sight
+    const AnimationClip& c = AnimationLibrary::get(clip);
+    if (c.frames.empty() && !AnimationLibrary::prepare(clip)) return;
+    const AnimationFrame& frame = c.frames[getFrame()];
+    if (frame.src.w <= 0) return; // nothing visible in this frame
+
+    // Frames are relative to the sheet, which may sit anywhere in an atlas page
+    SDL_Texture* texture = ImageDevice::get(c.texture);
+    SDL_Rect src = frame.src;
+    if (const SDL_Rect* region = ImageDevice::getRegion(c.texture)) {
+        src.x += region->x;
+        src.y += region->y;
     }
 
-    // Destination (object's location)
-    SDL_Rect dest = Engine::E->getView().transform(body->getRect());
+    // Only the visible part is drawn; sorting still uses the sprite's full bottom edge
+    SDL_FRect full = {float(dest.x), float(dest.y), float(dest.w), float(dest.h)};
+    SDL_FRect dst = placeFrame(full, c, frame, flip);
+    Engine::E->getRenderQueue().submit(RenderLayer::World, depth, full.y + full.h,
+                                       texture, &src, dst, 0.0f, SDL_RendererFlip(flip));
+}
+
+SDL_Rect AnimateComponent::getVisibleRect() {
+    BodyComponent* body = getObject()->getComponent<BodyComponent>();
+    if (!body) return SDL_Rect{0, 0, 0, 0};
 
-    SDL_RenderCopyEx(renderer, texture, &src, &dest, 0, NULL, flip);
+    SDL_Rect rect = body->getRect();
+    if (!AnimationLibrary::isValid(clip) || AnimationLibrary::get(clip).frames.empty()) return rect;
+
+    const AnimationClip& c = AnimationLibrary::get(clip);
+    SDL_FRect full = {float(rect.x), float(rect.y), float(rect.w), float(rect.h)};
+    SDL_FRect visible = placeFrame(full, c, c.frames[getFrame()], flip);
+    return SDL_Rect{int(visible.x), int(visible.y), int(std::ceil(visible.w)), int(std::ceil(visible.h))};
 }
 
 void AnimateComponent::setFlip(SDL_RendererFlip f) {
-    flip = f;
+    flip = uint8_t(f);
 }
 
-void AnimateComponent::setFrameTime(float newFrameTime) {
-    frameTimer.setDuration(newFrameTime);
-    frameTimer.reset();
-    frameTimer.start(); // Ensure timer is running
+void AnimateComponent::setClip(ClipId newClip) {
+    if (newClip == clip) return;
+    clip = newClip;
+    restart();
 }
 
-void AnimateComponent::setTexture(const std::string& newTextureName) {
-    // Use current frame count and dimensions
-    setTexture(newTextureName, frameCount, frameWidth, frameHeight, frameSpacing);
+void AnimateComponent::restart() {
+    startTime = Engine::E->getAnimationTime();
 }
 
-void AnimateComponent::setTexture(const std::string& newTextureName, int newFrameCount) {
-    // Use current frame dimensions and spacing
-    setTexture(newTextureName, newFrameCount, frameWidth, frameHeight, frameSpacing);
+void AnimateComponent::randomizePhase() {
+    if (!AnimationLibrary::isValid(clip)) return;
+
+    const AnimationClip& c = AnimationLibrary::get(clip);
+    float length = c.frameTime * c.frames.size();
+    phase = length * (float(std::rand()) / float(RAND_MAX));
 }
 
-void AnimateComponent::setTexture(const std::string& newTextureName, int newFrameCount, int newFrameWidth, int newFrameHeight, int newFrameSpacing) {
-    if (textureName == newTextureName && texture != nullptr && frameCount == newFrameCount 
-        && frameWidth == newFrameWidth && frameHeight == newFrameHeight && frameSpacing == newFrameSpacing) {
-        return; // Already using this texture with same settings
-    }
-    
-    textureName = newTextureName;
-    frameCount = newFrameCount;
-    frameWidth = newFrameWidth;
-    frameHeight = newFrameHeight;
-    frameSpacing = newFrameSpacing;
-    
-    SDL_Texture* newTexture = ImageDevice::get(textureName);
-    
-    if (!newTexture) {
-        std::cerr << "AnimateComponent: Failed to load texture '" << textureName << "'\n";
-        texture = nullptr;
-        return;
-    }
-    
-    texture = newTexture;
-    
-    // Verify dimensions match
-    int texW, texH;
-    if (SDL_QueryTexture(texture, NULL, NULL, &texW, &texH) == 0) {
-        std::cout << "AnimateComponent: Switched to '" << textureName 
-                  << "': frame size " << frameWidth << "x" << frameHeight 
-                  << " (total: " << texW << "x" << texH << ", frames: " << frameCount 
-                  << ", spacing: " << frameSpacing << ")\n";
-    }
-    
-    // Reset animation
-    currentFrame = 0;
-    frameTimer.reset();
-    frameTimer.start(); // Ensure timer is running after texture switch
-    std::cout << "AnimateComponent: Switched texture to '" << textureName 
-              << "', reset frame to 0, timer started\n";
+const std::string& AnimateComponent::getClipName() const {
+    return AnimationLibrary::isValid(clip) ? AnimationLibrary::get(clip).name : EMPTY_NAME;
+}
+
+const std::string& AnimateComponent::getTextureName() const {
+    return AnimationLibrary::isValid(clip) ? AnimationLibrary::get(clip).textureName : EMPTY_NAME;
 }
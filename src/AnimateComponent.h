@@ -1,11 +1,24 @@
 #pragma once
 #include "Component.h"
 #include <SDL.h>
+#include <cstdint>
 #include <string>
-#include "Timer.h"
+#include "AnimationLibrary.h"
+#include "RenderQueue.h"
 
+/**
+ * AnimateComponent - Plays a clip from the AnimationLibrary
+ *
+ * The clip itself (texture, frame rectangles, timing) is shared; an instance
+ * only tracks which clip it plays and when it started. The frame is derived
+ * at render time from the engine's animation clock, so there is no per-frame
+ * update and sprites culled off screen cost nothing.
+ */
 class AnimateComponent : public Component {
 public:
+    explicit AnimateComponent(ClipId clip);
+
+    // Sheet described inline (level files); compiled once and shared through the library
     AnimateComponent(const std::string& textureName,
                      int frameCount,
                      float frameTime,
@@ -13,37 +26,57 @@ public:
                      int frameHeight = 0,
                      int frameSpacing = 0);
 
-    void update(float dt) override;
     void render() override;
 
     void setFlip(SDL_RendererFlip flip);
     void setEnabled(bool enabled) { isEnabled = enabled; }
     bool getEnabled() const { return isEnabled; }
-    
-    // Switch to a different texture/animation
-    void setTexture(const std::string& newTextureName);
-    void setTexture(const std::string& newTextureName, int newFrameCount);
-    void setTexture(const std::string& newTextureName, int newFrameCount, int newFrameWidth, int newFrameHeight, int newFrameSpacing);
-    
-    // Set frame time (time per frame in seconds)
-    void setFrameTime(float newFrameTime);
-    
-    // Get current texture name
-    const std::string& getTextureName() const { return textureName; }
 
-private:
-    std::string textureName;
-    SDL_Texture* texture = nullptr;
+    // Switch clip; restarts from the first frame unless it is already playing
+    void setClip(ClipId newClip);
+    ClipId getClip() const { return clip; }
+
+    // Restart the current clip from its first frame
+    void restart();
+
+    // Playback speed multiplier (1 = the clip's own frame time)
+    void setRate(float r) { rate = r; }
+    float getRate() const { return rate; }
+
+    // Seconds added to the clip time, so identical sprites do not animate in lockstep
+    void setPhase(float seconds) { phase = seconds; }
+    float getPhase() const { return phase; }
+    // Random phase within the current clip's length
+    void randomizePhase();
 
-    int frameCount;
-    int currentFrame = 0;
+    // Frame the clip is on right now
+    size_t getFrame() const;
 
-    Timer frameTimer;    // Timer for frame transitions
+    // The current clip has reached its last frame at least once since it started
+    bool hasPlayedThrough() const;
 
-    int frameWidth;
-    int frameHeight;
-    int frameSpacing; // Pixels between frames (for sprite sheets with gaps)
+    // World rectangle of the current frame's visible pixels (transparent margins trimmed)
+    SDL_Rect getVisibleRect();
+
+    // Name of the current clip (empty if it has none)
+    const std::string& getClipName() const;
+
+    // Texture of the current clip (empty if it has none)
+    const std::string& getTextureName() const;
+
+    // Draw order inside the world layer (higher draws on top)
+    void setDepth(uint16_t d) { depth = d; }
+    uint16_t getDepth() const { return depth; }
+
+private:
+    // Seconds into the current clip
+    double clipTime() const;
 
-    SDL_RendererFlip flip = SDL_FLIP_NONE;
+    double startTime;      // animation clock when the clip started
+    float rate = 1.0f;
+    float phase = 0.0f;
+    ClipId clip = INVALID_CLIP;
+    uint16_t depth = RenderQueue::DEFAULT_WORLD_DEPTH;
+    uint8_t flip = SDL_FLIP_NONE;
     bool isEnabled = true; // Start enabled by default
 };
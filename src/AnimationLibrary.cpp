@@ -0,0 +1,166 @@
+#include "AnimationLibrary.h"
+#include "ImageDevice.h"
+#include "tinyxml2.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+using namespace tinyxml2;
+
+// Static member definitions
+std::vector<AnimationClip> AnimationLibrary::clips;
+std::unordered_map<std::string, ClipId> AnimationLibrary::names;
+std::unordered_map<std::string, ClipId> AnimationLibrary::sheets;
+
+bool AnimationLibrary::loadFromXML(const std::string& xmlPath) {
+    XMLDocument doc;
+    if (doc.LoadFile(xmlPath.c_str()) != XML_SUCCESS) {
+        std::cerr << "AnimationLibrary: Failed to load " << xmlPath << std::endl;
+        return false;
+    }
+
+    XMLElement* root = doc.FirstChildElement("Assets");
+    if (!root) {
+        std::cerr << "AnimationLibrary: No <Assets> root element in " << xmlPath << std::endl;
+        return false;
+    }
+
+    for (XMLElement* anim = root->FirstChildElement("Animation"); anim; anim = anim->NextSiblingElement("Animation")) {
+        const char* name = anim->Attribute("name");
+        const char* texture = anim->Attribute("texture");
+        if (!name || !texture) {
+            std::cerr << "AnimationLibrary: Animation entry missing name or texture attribute in " << xmlPath << std::endl;
+            continue;
+        }
+
+        define(name, texture,
+               anim->IntAttribute("frames", 0),
+               anim->FloatAttribute("time", 0.1f),
+               anim->IntAttribute("frameWidth", 0),
+               anim->IntAttribute("frameHeight", 0),
+               anim->IntAttribute("spacing", 0),
+               anim->BoolAttribute("loop", true));
+    }
+
+    return true;
+}
+
+ClipId AnimationLibrary::define(const std::string& name, const std::string& textureName,
+                                int frameCount, float frameTime,
+                                int frameWidth, int frameHeight, int frameSpacing, bool loop) {
+    TextureHandle texture = ImageDevice::getHandle(textureName);
+    if (!ImageDevice::isRegistered(texture)) {
+        std::cerr << "AnimationLibrary: Clip '" << name << "' has no texture '" << textureName << "'" << std::endl;
+        return INVALID_CLIP;
+    }
+    if (clips.size() >= INVALID_CLIP) {
+        std::cerr << "AnimationLibrary: Too many clips, '" << name << "' not added" << std::endl;
+        return INVALID_CLIP;
+    }
+
+    AnimationClip clip;
+    clip.name = name;
+    clip.textureName = textureName;
+    clip.texture = texture;
+    clip.frameTime = frameTime > 0.0f ? frameTime : 0.1f;
+    clip.loop = loop;
+    clip.frameCount = frameCount;
+    clip.frameWidth = frameWidth;
+    clip.frameHeight = frameHeight;
+    clip.frameSpacing = frameSpacing;
+    // Otherwise built by prepare() or resolvePending() once the sheet is in
+    if (ImageDevice::isResident(texture) && !compile(clip)) return INVALID_CLIP;
+
+    // Redefining a name replaces the clip in place so existing ids stay valid
+    auto it = names.find(name);
+    if (it != names.end()) {
+        clips[it->second] = std::move(clip);
+        return it->second;
+    }
+
+    ClipId id = ClipId(clips.size());
+    clips.push_back(std::move(clip));
+    names[name] = id;
+    return id;
+}
+
+bool AnimationLibrary::compile(AnimationClip& clip) {
+    // The sheet may be a region of an atlas page; frames are laid out inside it
+    SDL_Rect area = ImageDevice::getArea(clip.texture);
+    int texW = area.w, texH = area.h;
+
+    // Missing sizes come from the sheet: a single row of frameCount frames
+    int frameCount = clip.frameCount;
+    int frameWidth = clip.frameWidth;
+    int frameHeight = clip.frameHeight;
+    int frameSpacing = clip.frameSpacing;
+    int count = std::max(frameCount, 1);
+    if (frameWidth <= 0) frameWidth = (texW - frameSpacing * (count - 1)) / count;
+    if (frameHeight <= 0) frameHeight = texH;
+    if (frameWidth <= 0 || frameHeight <= 0) {
+        std::cerr << "AnimationLibrary: Invalid frame size for '" << clip.name << "'" << std::endl;
+        return false;
+    }
+
+    int columns = std::max((texW + frameSpacing) / (frameWidth + frameSpacing), 1);
+    int rows = std::max((texH + frameSpacing) / (frameHeight + frameSpacing), 1);
+    if (frameCount <= 0) frameCount = columns * rows;
+
+    clip.frameWidth = frameWidth;
+    clip.frameHeight = frameHeight;
+    clip.frames.clear();
+    clip.frames.reserve(frameCount);
+    const AlphaMask* mask = ImageDevice::getAlphaMask(clip.texture);
+    long long fullArea = 0, trimmedArea = 0;
+    for (int i = 0; i < frameCount; ++i) {
+        int column = i % columns;
+        int row = i / columns;
+        SDL_Rect full = {column * (frameWidth + frameSpacing), row * (frameHeight + frameSpacing),
+                         frameWidth, frameHeight};
+        SDL_Rect src = mask ? mask->trim(full) : full;
+        SDL_Point offset{src.x - full.x, src.y - full.y};
+        clip.frames.push_back(AnimationFrame{src, offset});
+        fullArea += full.w * full.h;
+        trimmedArea += src.w * src.h;
+    }
+
+    std::cout << "AnimationLibrary: Compiled '" << clip.name << "' (" << frameCount << " frames of "
+              << frameWidth << "x" << frameHeight << ", " << (fullArea > 0 ? trimmedArea * 100 / fullArea : 0)
+              << "% visible)" << std::endl;
+    return true;
+}
+
+bool AnimationLibrary::prepare(ClipId id) {
+    if (!isValid(id)) return false;
+    AnimationClip& clip = clips[id];
+    if (!clip.frames.empty()) return true;
+    if (!ImageDevice::ensureResident(clip.texture)) return false;
+    return compile(clip);
+}
+
+void AnimationLibrary::resolvePending() {
+    for (AnimationClip& clip : clips) {
+        if (clip.frames.empty() && ImageDevice::isResident(clip.texture)) compile(clip);
+    }
+}
+
+ClipId AnimationLibrary::fromSheet(const std::string& textureName, int frameCount, float frameTime,
+                                   int frameWidth, int frameHeight, int frameSpacing) {
+    std::ostringstream key;
+    key << textureName << '|' << frameCount << '|' << frameTime << '|'
+        << frameWidth << '|' << frameHeight << '|' << frameSpacing;
+
+    auto it = sheets.find(key.str());
+    if (it != sheets.end()) return it->second;
+
+    // The first description of a texture is also findable by the texture's name
+    std::string name = names.count(textureName) ? key.str() : textureName;
+    ClipId id = define(name, textureName, frameCount, frameTime, frameWidth, frameHeight, frameSpacing);
+    if (id != INVALID_CLIP) sheets[key.str()] = id;
+    return id;
+}
+
+ClipId AnimationLibrary::find(const std::string& name) {
+    auto it = names.find(name);
+    return it != names.end() ? it->second : INVALID_CLIP;
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ImageDevice.h"
+
+// Small integer handle to a compiled clip
+using ClipId = uint16_t;
+static constexpr ClipId INVALID_CLIP = 0xFFFF;
+
+/**
+ * One frame of a clip, trimmed to its visible pixels
+ */
+struct AnimationFrame {
+    SDL_Rect src;     // visible part of the frame in the sheet image (w = 0 if the frame is fully transparent)
+    SDL_Point offset; // src's top-left inside the untrimmed frame
+};
+
+/**
+ * A compiled animation clip: one source rectangle per frame, baked once
+ *
+ * Frames are relative to the sheet image, not to the SDL texture it lives in,
+ * so they survive the sheet being evicted and reloaded into another atlas
+ * page; add ImageDevice::getRegion(texture) when drawing.
+ */
+struct AnimationClip {
+    std::string name;
+    std::string textureName;
+    TextureHandle texture = INVALID_TEXTURE;
+    std::vector<AnimationFrame> frames; // empty until the sheet has been resident once (see prepare)
+    int frameWidth = 0;                  // untrimmed frame size, what a sprite's rect maps to
+    int frameHeight = 0;
+    float frameTime = 0.1f;       // seconds per frame
+    bool loop = true;             // otherwise holds the last frame
+
+    // Layout as defined (0 = derive from the sheet), kept until the frames are built
+    int frameCount = 0;
+    int frameSpacing = 0;
+};
+
+/**
+ * AnimationLibrary - Animation clips shared by every AnimateComponent
+ *
+ * Works like ImageDevice: clips are defined once (assets/animations.xml, or
+ * derived from a sprite sheet the first time a component asks for it) and
+ * compiled into immutable frame-rect tables the first time their sheet is
+ * resident (sheets are streamed in per level, so that may be after define).
+ * Components only keep a ClipId and a frame index, so drawing an animated
+ * sprite is a single table lookup.
+ * Frames are trimmed to their visible pixels using ImageDevice's alpha mask, so
+ * the transparent margins of a sheet are never drawn.
+ */
+class AnimationLibrary {
+public:
+    /**
+     * Load <Animation> entries from an XML file
+     *
+     * <Animation name="maskdude_run" texture="maskdude_run" frameWidth="32" frameHeight="32" time="0.05"/>
+     * frames defaults to as many frames as fit in the sheet; spacing is the gap
+     * between frames; loop="false" holds the last frame.
+     */
+    static bool loadFromXML(const std::string& xmlPath);
+
+    /**
+     * Compile a clip from a sprite sheet laid out left to right (wrapping into rows)
+     * @param frameCount 0 = every frame that fits in the sheet
+     * @param frameWidth,frameHeight 0 = derive from the sheet size and frame count
+     * @return the clip id, or INVALID_CLIP if the texture is not registered
+     */
+    static ClipId define(const std::string& name, const std::string& textureName,
+                         int frameCount, float frameTime,
+                         int frameWidth = 0, int frameHeight = 0, int frameSpacing = 0,
+                         bool loop = true);
+
+    /**
+     * Clip for a sheet described inline (level files); identical descriptions share one clip
+     */
+    static ClipId fromSheet(const std::string& textureName, int frameCount, float frameTime,
+                            int frameWidth = 0, int frameHeight = 0, int frameSpacing = 0);
+
+    // Clip id by name, INVALID_CLIP if there is none
+    static ClipId find(const std::string& name);
+
+    // Build the frames of a clip whose sheet was not resident yet, loading it if needed
+    static bool prepare(ClipId id);
+
+    // Build the frames of every clip whose sheet has become resident (after a level's textures are in)
+    static void resolvePending();
+
+    // Callers must pass a valid id (checked with isValid)
+    static const AnimationClip& get(ClipId id) { return clips[id]; }
+    static bool isValid(ClipId id) { return id < clips.size(); }
+
+private:
+    // Lay out and trim the frames from the sheet's size and alpha mask; the sheet must be resident
+    static bool compile(AnimationClip& clip);
+
+    static std::vector<AnimationClip> clips;               // indexed by ClipId
+    static std::unordered_map<std::string, ClipId> names;
+    static std::unordered_map<std::string, ClipId> sheets; // inline sheet description -> clip
+};
@@ -0,0 +1,198 @@
+#include "AnimationStateMachine.h"
+#include "tinyxml2.h"
+#include <iostream>
+#include <sstream>
+
+using namespace tinyxml2;
+
+// Static member definitions
+std::vector<StateMachine> AnimationStateMachine::machines;
+std::unordered_map<std::string, MachineId> AnimationStateMachine::names;
+
+bool AnimationStateMachine::loadFromXML(const std::string& xmlPath) {
+    XMLDocument doc;
+    if (doc.LoadFile(xmlPath.c_str()) != XML_SUCCESS) {
+        std::cerr << "AnimationStateMachine: Failed to load " << xmlPath << std::endl;
+        return false;
+    }
+
+    XMLElement* root = doc.FirstChildElement("Assets");
+    if (!root) {
+        std::cerr << "AnimationStateMachine: No <Assets> root element in " << xmlPath << std::endl;
+        return false;
+    }
+
+    for (XMLElement* elem = root->FirstChildElement("StateMachine"); elem; elem = elem->NextSiblingElement("StateMachine")) {
+        const char* name = elem->Attribute("name");
+        if (!name) {
+            std::cerr << "AnimationStateMachine: StateMachine entry missing name attribute in " << xmlPath << std::endl;
+            continue;
+        }
+
+        StateMachine machine;
+        machine.name = name;
+        if (!compile(elem, machine)) {
+            std::cerr << "AnimationStateMachine: Skipping '" << name << "'" << std::endl;
+            continue;
+        }
+
+        // Redefining a name replaces the machine in place so existing ids stay valid
+        auto it = names.find(name);
+        if (it != names.end()) {
+            machines[it->second] = std::move(machine);
+        } else {
+            names[name] = MachineId(machines.size());
+            machines.push_back(std::move(machine));
+        }
+        std::cout << "AnimationStateMachine: Compiled '" << name << "'" << std::endl;
+    }
+
+    return true;
+}
+
+bool AnimationStateMachine::compile(const XMLElement* elem, StateMachine& machine) {
+    for (const XMLElement* p = elem->FirstChildElement("Parameter"); p; p = p->NextSiblingElement("Parameter")) {
+        const char* name = p->Attribute("name");
+        if (!name) continue;
+        if (machine.parameterNames.size() >= MAX_PARAMETERS) {
+            std::cerr << "AnimationStateMachine: More than " << MAX_PARAMETERS << " parameters in '" << machine.name << "'" << std::endl;
+            return false;
+        }
+
+        std::string type = p->Attribute("type") ? p->Attribute("type") : "float";
+        machine.parameterNames.push_back(name);
+        machine.parameterTypes.push_back(type == "bool" ? ParamType::Bool
+                                       : type == "trigger" ? ParamType::Trigger
+                                       : ParamType::Float);
+    }
+
+    std::unordered_map<std::string, StateId> stateIds;
+    for (const XMLElement* s = elem->FirstChildElement("State"); s; s = s->NextSiblingElement("State")) {
+        const char* name = s->Attribute("name");
+        const char* clip = s->Attribute("clip");
+        if (!name || !clip) {
+            std::cerr << "AnimationStateMachine: State in '" << machine.name << "' missing name or clip" << std::endl;
+            return false;
+        }
+        if (machine.states.size() >= ANY_STATE) return false;
+
+        AnimState state;
+        state.name = name;
+        state.clip = AnimationLibrary::find(clip);
+        if (state.clip == INVALID_CLIP) {
+            std::cerr << "AnimationStateMachine: Unknown clip '" << clip << "' in '" << machine.name << "'" << std::endl;
+        }
+        stateIds[name] = StateId(machine.states.size());
+        machine.states.push_back(state);
+    }
+    if (machine.states.empty()) return false;
+
+    if (const char* entry = elem->Attribute("entry")) {
+        auto it = stateIds.find(entry);
+        if (it == stateIds.end()) {
+            std::cerr << "AnimationStateMachine: Unknown entry state '" << entry << "'" << std::endl;
+            return false;
+        }
+        machine.entry = it->second;
+    }
+
+    // Gather transitions per source state (ANY_STATE last), keeping document order within each
+    std::vector<std::vector<AnimTransition>> bySource(machine.states.size() + 1);
+    std::vector<std::vector<std::vector<AnimCondition>>> conditionsBySource(machine.states.size() + 1);
+    for (const XMLElement* t = elem->FirstChildElement("Transition"); t; t = t->NextSiblingElement("Transition")) {
+        const char* from = t->Attribute("from");
+        const char* to = t->Attribute("to");
+        if (!from || !to || !stateIds.count(to) || (std::string(from) != "any" && !stateIds.count(from))) {
+            std::cerr << "AnimationStateMachine: Bad transition in '" << machine.name << "'" << std::endl;
+            return false;
+        }
+        size_t source = std::string(from) == "any" ? machine.states.size() : stateIds[from];
+
+        std::vector<AnimCondition> conditions;
+        if (const char* when = t->Attribute("when")) {
+            // Comparisons joined by "and"
+            std::string text = when;
+            size_t start = 0;
+            while (start <= text.size()) {
+                size_t end = text.find(" and ", start);
+                if (end == std::string::npos) end = text.size();
+                AnimCondition condition;
+                if (!parseCondition(text.substr(start, end - start), machine, condition)) {
+                    std::cerr << "AnimationStateMachine: Bad condition '" << when << "' in '" << machine.name << "'" << std::endl;
+                    return false;
+                }
+                conditions.push_back(condition);
+                start = end + 5;
+            }
+        }
+
+        AnimTransition transition;
+        transition.to = stateIds[to];
+        transition.onClipEnd = t->BoolAttribute("exit", false);
+        transition.firstCondition = 0;
+        transition.conditionCount = uint16_t(conditions.size());
+        bySource[source].push_back(transition);
+        conditionsBySource[source].push_back(std::move(conditions));
+    }
+
+    // Flatten into contiguous ranges
+    for (size_t source = 0; source < bySource.size(); ++source) {
+        uint16_t first = uint16_t(machine.transitions.size());
+        for (size_t i = 0; i < bySource[source].size(); ++i) {
+            AnimTransition transition = bySource[source][i];
+            transition.firstCondition = uint16_t(machine.conditions.size());
+            for (const AnimCondition& condition : conditionsBySource[source][i]) {
+                machine.conditions.push_back(condition);
+            }
+            machine.transitions.push_back(transition);
+        }
+        uint16_t count = uint16_t(bySource[source].size());
+        if (source == machine.states.size()) {
+            machine.firstAnyTransition = first;
+            machine.anyTransitionCount = count;
+        } else {
+            machine.states[source].firstTransition = first;
+            machine.states[source].transitionCount = count;
+        }
+    }
+
+    return true;
+}
+
+bool AnimationStateMachine::parseCondition(const std::string& text, const StateMachine& machine, AnimCondition& condition) {
+    std::istringstream in(text);
+    std::string param, op;
+    float value = 0.0f;
+    if (!(in >> param >> op >> value)) return false;
+
+    condition.param = INVALID_PARAM;
+    for (size_t i = 0; i < machine.parameterNames.size(); ++i) {
+        if (machine.parameterNames[i] == param) condition.param = ParamId(i);
+    }
+    if (condition.param == INVALID_PARAM) return false;
+
+    if (op == ">") condition.op = ConditionOp::Greater;
+    else if (op == ">=") condition.op = ConditionOp::GreaterEqual;
+    else if (op == "<") condition.op = ConditionOp::Less;
+    else if (op == "<=") condition.op = ConditionOp::LessEqual;
+    else if (op == "==") condition.op = ConditionOp::Equal;
+    else if (op == "!=") condition.op = ConditionOp::NotEqual;
+    else return false;
+
+    condition.value = value;
+    return true;
+}
+
+MachineId AnimationStateMachine::find(const std::string& name) {
+    auto it = names.find(name);
+    return it != names.end() ? it->second : INVALID_MACHINE;
+}
+
+ParamId AnimationStateMachine::findParameter(MachineId id, const std::string& name) {
+    if (!isValid(id)) return INVALID_PARAM;
+    const StateMachine& machine = machines[id];
+    for (size_t i = 0; i < machine.parameterNames.size(); ++i) {
+        if (machine.parameterNames[i] == name) return ParamId(i);
+    }
+    return INVALID_PARAM;
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "AnimationLibrary.h"
+
+namespace tinyxml2 { class XMLElement; }
+
+using MachineId = uint16_t;
+using StateId = uint8_t;
+using ParamId = uint8_t;
+static constexpr MachineId INVALID_MACHINE = 0xFFFF;
+static constexpr StateId ANY_STATE = 0xFF;
+static constexpr ParamId INVALID_PARAM = 0xFF;
+
+enum class ParamType : uint8_t {
+    Float,
+    Bool,
+    Trigger // reads as 1 until a transition that tests it fires
+};
+
+enum class ConditionOp : uint8_t {
+    Greater,
+    GreaterEqual,
+    Less,
+    LessEqual,
+    Equal,
+    NotEqual
+};
+
+struct AnimCondition {
+    ParamId param;
+    ConditionOp op;
+    float value;
+};
+
+struct AnimTransition {
+    StateId to;
+    bool onClipEnd;          // also wait for the current clip to play through once
+    uint16_t firstCondition; // range in StateMachine::conditions, all must hold
+    uint16_t conditionCount;
+};
+
+struct AnimState {
+    std::string name;
+    ClipId clip = INVALID_CLIP;
+    uint16_t firstTransition = 0; // range in StateMachine::transitions, tested in order
+    uint16_t transitionCount = 0;
+};
+
+/**
+ * A compiled state machine: names only survive for lookups at setup time,
+ * evaluation works on the index tables
+ */
+struct StateMachine {
+    std::string name;
+    std::vector<std::string> parameterNames;
+    std::vector<ParamType> parameterTypes;
+    std::vector<AnimState> states;
+    std::vector<AnimTransition> transitions;
+    std::vector<AnimCondition> conditions;
+    uint16_t firstAnyTransition = 0; // transitions from="any", tested before the state's own
+    uint16_t anyTransitionCount = 0;
+    StateId entry = 0;
+};
+
+/**
+ * AnimationStateMachine - Animation state machines shared by every AnimatorComponent
+ *
+ * Loaded from <StateMachine> entries in an asset file and compiled once, with
+ * states, clips and parameters resolved to small integer ids:
+ *
+ * <StateMachine name="maskdude" entry="idle">
+ *     <Parameter name="speed" />
+ *     <Parameter name="grounded" type="bool" />
+ *     <Parameter name="hit" type="trigger" />
+ *     <State name="idle" clip="maskdude_idle" />
+ *     <State name="run" clip="maskdude_run" />
+ *     <Transition from="idle" to="run" when="speed > 10 and grounded == 1" />
+ *     <Transition from="any" to="hit" when="hit == 1" />
+ *     <Transition from="hit" to="idle" exit="true" />
+ * </StateMachine>
+ *
+ * "when" joins comparisons (> >= &lt; &lt;= == !=) against a number with "and";
+ * exit="true" also waits for the current clip to play through once.
+ */
+class AnimationStateMachine {
+public:
+    static constexpr size_t MAX_PARAMETERS = 8;
+
+    static bool loadFromXML(const std::string& xmlPath);
+
+    // Machine id by name, INVALID_MACHINE if there is none
+    static MachineId find(const std::string& name);
+
+    // Callers must pass a valid id (checked with isValid)
+    static const StateMachine& get(MachineId id) { return machines[id]; }
+    static bool isValid(MachineId id) { return id < machines.size(); }
+
+    // Parameter id by name, INVALID_PARAM if the machine has no such parameter
+    static ParamId findParameter(MachineId id, const std::string& name);
+
+private:
+    static bool compile(const tinyxml2::XMLElement* element, StateMachine& machine);
+    static bool parseCondition(const std::string& text, const StateMachine& machine, AnimCondition& condition);
+
+    static std::vector<StateMachine> machines; // indexed by MachineId
+    static std::unordered_map<std::string, MachineId> names;
+};
@@ -0,0 +1,83 @@
+#include "AnimatorComponent.h"
+#include "AnimateComponent.h"
+#include "Object.h"
+
+AnimatorComponent::AnimatorComponent(MachineId machine)
+    : machine(machine)
+{
+}
+
+ParamId AnimatorComponent::findParameter(const std::string& name) const {
+    return AnimationStateMachine::findParameter(machine, name);
+}
+
+void AnimatorComponent::setFloat(ParamId param, float value) {
+    if (param < parameters.size()) parameters[param] = value;
+}
+
+void AnimatorComponent::setBool(ParamId param, bool value) {
+    setFloat(param, value ? 1.0f : 0.0f);
+}
+
+void AnimatorComponent::setTrigger(ParamId param) {
+    setFloat(param, 1.0f);
+}
+
+void AnimatorComponent::update(float /*dt*/) {
+    if (!AnimationStateMachine::isValid(machine)) return;
+    const StateMachine& m = AnimationStateMachine::get(machine);
+
+    if (!animate) {
+        animate = getObject()->getComponent<AnimateComponent>();
+        if (!animate) return;
+    }
+    if (!started) {
+        started = true;
+        enter(m, m.entry);
+    }
+
+    // Transitions from any state first, then the current state's own, first match wins
+    const AnimState& current = m.states[state];
+    const AnimTransition* fired = nullptr;
+    for (uint16_t i = 0; i < m.anyTransitionCount && !fired; ++i) {
+        const AnimTransition& t = m.transitions[m.firstAnyTransition + i];
+        if (t.to != state && conditionsHold(m, t)) fired = &t;
+    }
+    for (uint16_t i = 0; i < current.transitionCount && !fired; ++i) {
+        const AnimTransition& t = m.transitions[current.firstTransition + i];
+        if (conditionsHold(m, t)) fired = &t;
+    }
+    if (!fired) return;
+
+    // Triggers are used up by the transition that tested them
+    for (uint16_t i = 0; i < fired->conditionCount; ++i) {
+        ParamId param = m.conditions[fired->firstCondition + i].param;
+        if (m.parameterTypes[param] == ParamType::Trigger) parameters[param] = 0.0f;
+    }
+    enter(m, fired->to);
+}
+
+bool AnimatorComponent::conditionsHold(const StateMachine& m, const AnimTransition& transition) const {
+    if (transition.onClipEnd && !animate->hasPlayedThrough()) return false;
+
+    for (uint16_t i = 0; i < transition.conditionCount; ++i) {
+        const AnimCondition& c = m.conditions[transition.firstCondition + i];
+        float v = parameters[c.param];
+        bool holds = false;
+        switch (c.op) {
+            case ConditionOp::Greater:      holds = v > c.value; break;
+            case ConditionOp::GreaterEqual: holds = v >= c.value; break;
+            case ConditionOp::Less:         holds = v < c.value; break;
+            case ConditionOp::LessEqual:    holds = v <= c.value; break;
+            case ConditionOp::Equal:        holds = v == c.value; break;
+            case ConditionOp::NotEqual:     holds = v != c.value; break;
+        }
+        if (!holds) return false;
+    }
+    return true;
+}
+
+void AnimatorComponent::enter(const StateMachine& m, StateId next) {
+    state = next;
+    animate->setClip(m.states[next].clip);
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "Component.h"
+#include <array>
+#include "AnimationStateMachine.h"
+
+class AnimateComponent;
+
+/**
+ * AnimatorComponent - Runs a compiled AnimationStateMachine on its object
+ *
+ * Gameplay code sets parameters by id (resolve names once with findParameter);
+ * every update the current state's transitions are tested against them and
+ * the AnimateComponent on the same object is switched to the new state's clip.
+ */
+class AnimatorComponent : public Component {
+public:
+    explicit AnimatorComponent(MachineId machine);
+
+    void update(float dt) override;
+
+    ParamId findParameter(const std::string& name) const;
+
+    // Ignored for INVALID_PARAM, so unresolved parameters need no checks at the call site
+    void setFloat(ParamId param, float value);
+    void setBool(ParamId param, bool value);
+    void setTrigger(ParamId param);
+
+    MachineId getMachine() const { return machine; }
+    StateId getState() const { return state; }
+
+private:
+    bool conditionsHold(const StateMachine& m, const AnimTransition& transition) const;
+    void enter(const StateMachine& m, StateId next);
+
+    AnimateComponent* animate = nullptr; // found on the first update
+    std::array<float, AnimationStateMachine::MAX_PARAMETERS> parameters{};
+    MachineId machine;
+    StateId state = 0;
+    bool started = false;
+};
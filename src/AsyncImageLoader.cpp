@@ -0,0 +1,73 @@
+#include "AsyncImageLoader.h"
+#include <SDL_image.h>
+#include <iostream>
+
+AsyncImageLoader::~AsyncImageLoader() {
+    join();
+
+    // Results nobody picked up
+    for (size_t i = head; i < tail.load(std::memory_order_acquire); ++i) {
+        if (slots[i].image.surface) SDL_FreeSurface(slots[i].image.surface);
+    }
+}
+
+void AsyncImageLoader::join() {
+    if (thread.joinable()) thread.join();
+}
+
+void AsyncImageLoader::start(std::vector<std::pair<std::string, std::string>> newFiles, Uint32 pixelFormat) {
+    join();
+    if (isBusy()) {
+        std::cerr << "AsyncImageLoader: Previous batch not finished, ignoring the new one" << std::endl;
+        return;
+    }
+
+    files = std::move(newFiles);
+    format = pixelFormat;
+    total = files.size();
+    head = 0;
+    tail.store(0, std::memory_order_relaxed);
+    slots.reset(new Slot[total]);
+    if (total == 0) return;
+
+    thread = std::thread([this]() {
+        pool.parallelFor(files.size(), 1, [this](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) decode(i);
+        });
+    });
+}
+
+void AsyncImageLoader::decode(size_t index) {
+    DecodedImage image;
+    image.name = files[index].first;
+    image.file = files[index].second;
+
+    image.surface = IMG_Load(image.file.c_str());
+    if (!image.surface) {
+        std::cerr << "AsyncImageLoader: Failed to load image '" << image.file << "': " << IMG_GetError() << std::endl;
+    } else {
+        // The mask needs the original alpha/colour key, so it comes before the conversion
+        image.hasMask = ImageDevice::buildAlphaMask(image.surface, image.mask);
+        if (format != SDL_PIXELFORMAT_UNKNOWN && image.surface->format->format != format) {
+            if (SDL_Surface* converted = SDL_ConvertSurfaceFormat(image.surface, format, 0)) {
+                SDL_FreeSurface(image.surface);
+                image.surface = converted;
+            }
+        }
+    }
+
+    // Claim a slot, fill it, then publish it
+    Slot& slot = slots[tail.fetch_add(1, std::memory_order_relaxed)];
+    slot.image = std::move(image);
+    slot.ready.store(true, std::memory_order_release);
+}
+
+bool AsyncImageLoader::poll(DecodedImage& out) {
+    if (head >= total || !slots[head].ready.load(std::memory_order_acquire)) return false;
+
+    out = std::move(slots[head].image);
+    slots[head].image.surface = nullptr;
+    ++head;
+    if (head == total) join();
+    return true;
+}
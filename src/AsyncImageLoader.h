@@ -0,0 +1,76 @@
+#pragma once
+#include <SDL.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "ImageDevice.h"
+#include "WorkerPool.h"
+
+/**
+ * An image decoded off the main thread, waiting to become a texture
+ */
+struct DecodedImage {
+    std::string name;
+    std::string file;
+    SDL_Surface* surface = nullptr; // nullptr if the file could not be decoded
+    AlphaMask mask;
+    bool hasMask = false;
+};
+
+/**
+ * AsyncImageLoader - Decodes image files on worker threads
+ *
+ * start() hands the whole list to a loader thread that splits it over a
+ * WorkerPool. Each worker decodes with IMG_Load, converts the pixels to the
+ * renderer's preferred format (so the upload is a plain copy) and builds the
+ * alpha mask, then publishes the result into a slot of a fixed-size queue:
+ * producers claim slots with an atomic counter and set a per-slot ready flag,
+ * so neither side ever takes a lock. poll() hands results back in completion
+ * order to the single consumer (the main thread), which uploads them.
+ */
+class AsyncImageLoader {
+public:
+    AsyncImageLoader() = default;
+    ~AsyncImageLoader();
+
+    AsyncImageLoader(const AsyncImageLoader&) = delete;
+    AsyncImageLoader& operator=(const AsyncImageLoader&) = delete;
+
+    void setWorkerCount(unsigned count) { pool.setWorkerCount(count); }
+
+    /**
+     * Start decoding (name, file) pairs; the previous batch must have been fully polled
+     * @param pixelFormat Format to convert to, SDL_PIXELFORMAT_UNKNOWN to keep the file's
+     */
+    void start(std::vector<std::pair<std::string, std::string>> files, Uint32 pixelFormat);
+
+    // Take the next finished image; false if none is ready yet
+    bool poll(DecodedImage& out);
+
+    size_t getTotal() const { return total; }
+    size_t getPolled() const { return head; }
+    bool isBusy() const { return head < total; }
+
+private:
+    struct Slot {
+        DecodedImage image;
+        std::atomic<bool> ready{false};
+    };
+
+    void decode(size_t index);
+    void join();
+
+    std::vector<std::pair<std::string, std::string>> files;
+    Uint32 format = SDL_PIXELFORMAT_UNKNOWN;
+
+    std::unique_ptr<Slot[]> slots;  // one per file, filled in completion order
+    std::atomic<size_t> tail{0};    // next slot a producer claims
+    size_t head = 0;                // next slot the consumer reads
+    size_t total = 0;
+
+    WorkerPool pool;
+    std::thread thread;             // runs parallelFor so start() returns at once
+};
@@ -6,6 +6,8 @@
 #include "GroundComponent.h"
 #include "InputDevice.h"
 #include "AnimateComponent.h"
+#include "AnimatorComponent.h"
+#include "HealthComponent.h"
 #include <iostream>
 #include <cmath>
 
@@ -100,6 +102,12 @@ void CharacterComponent::update(float dt) {
         }
     }
 
+    // Tile layers have no objects to scan; probe a thin strip under the feet instead
+    if (!onGround && vy >= -0.5f &&
+        Engine::E->overlapsSolidTile(playerLeft + 2.0f, playerBottom - 1.0f, pw - 4.0f, 5.0f)) {
+        onGround = true;
+    }
+
     // --- Input handling ---
     float newVx = 0;
     bool leftPressed = InputDevice::isKeyDown(SDL_SCANCODE_A);
@@ -130,9 +138,6 @@ void CharacterComponent::update(float dt) {
     auto* animate = getObject()->getComponent<AnimateComponent>();
     auto* sprite = getObject()->getComponent<SpriteComponent>();
     
-    // Check if player is moving horizontally
-    bool isMoving = std::abs(newVx) > 0.1f;
-    
     // Update flip state based on input (not just movement)
     // This way the flip persists even when player stops
     if (leftPressed) {
@@ -146,24 +151,38 @@ void CharacterComponent::update(float dt) {
         // Always apply the flip state to both components
         animate->setFlip(lastFlip);
         sprite->setFlip(lastFlip);
-        
-        if (isMoving) {
-            // Walking: switch to walk animation
-            if (animate->getTextureName() != "playerGIGIwalk6") {
-                animate->setTexture("playerGIGIwalk6", 6, 64, 64, 10);
-            }
-            animate->setEnabled(true);
-            sprite->setEnabled(false);
-        } else {
-            // Idle: switch to idle animation
-            if (animate->getTextureName() != "playerGIGIIdle") {
-                animate->setTexture("playerGIGIIdle", 6, 64, 64, 10);
-            }
-            // Always enable animation when idle (it should be animating)
-            animate->setEnabled(true);
-            sprite->setEnabled(false);
+        animate->setEnabled(true);
+        sprite->setEnabled(false);
+    }
+
+    // The animator picks the clip; it only needs the current movement state
+    if (auto* animator = getObject()->getComponent<AnimatorComponent>()) {
+        if (!animatorResolved) {
+            animatorResolved = true;
+            speedParam = animator->findParameter("speed");
+            vyParam = animator->findParameter("vy");
+            groundedParam = animator->findParameter("grounded");
+            hitParam = animator->findParameter("hit");
         }
+
+        animator->setFloat(speedParam, std::abs(newVx));
+        animator->setFloat(vyParam, body->getVy());
+        animator->setBool(groundedParam, onGround);
+    }
+
+    // Hits and landings: animator trigger and particle effects
+    auto* health = getObject()->getComponent<HealthComponent>();
+    bool hit = health && health->isInvulnerable();
+    if (hit && !wasHit) {
+        if (auto* animator = getObject()->getComponent<AnimatorComponent>()) animator->setTrigger(hitParam);
+        Engine::E->getParticles().burst("hit_sparks", body->getX(), body->getY());
+    }
+    wasHit = hit;
+
+    if (onGround && !wasOnGround) {
+        Engine::E->getParticles().burst("dust", body->getX(), body->getY() + ph / 2);
     }
+    wasOnGround = onGround;
 
     // --- Clamp horizontal position to world bounds ---
     float finalX = body->getX();
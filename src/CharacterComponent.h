@@ -1,6 +1,7 @@
 #pragma once
 #include "Component.h"
 #include <SDL.h>
+#include "AnimationStateMachine.h"
 
 class CharacterComponent : public Component {
 public:
@@ -10,5 +11,14 @@ public:
     
 private:
     SDL_RendererFlip lastFlip = SDL_FLIP_NONE; // Remember last flip direction
+
+    // Animator parameter ids, looked up once on the first update
+    bool animatorResolved = false;
+    ParamId speedParam = INVALID_PARAM;
+    ParamId vyParam = INVALID_PARAM;
+    ParamId groundedParam = INVALID_PARAM;
+    ParamId hitParam = INVALID_PARAM;
+    bool wasHit = false;
+    bool wasOnGround = true;
 };
 
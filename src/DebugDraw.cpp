@@ -0,0 +1,273 @@
+#include "DebugDraw.h"
+#include "View.h"
+#include <cmath>
+#include <iostream>
+#include <utility>
+
+DebugDraw::DebugDraw() {
+    b2Draw = b2DefaultDebugDraw();
+    b2Draw.DrawPolygonFcn = drawPolygon;
+    b2Draw.DrawSolidPolygonFcn = drawSolidPolygon;
+    b2Draw.DrawCircleFcn = drawCircle;
+    b2Draw.DrawSolidCircleFcn = drawSolidCircle;
+    b2Draw.DrawSolidCapsuleFcn = drawSolidCapsule;
+    b2Draw.DrawSegmentFcn = drawSegment;
+    b2Draw.DrawTransformFcn = drawTransform;
+    b2Draw.DrawPointFcn = drawPoint;
+    b2Draw.DrawStringFcn = drawString;
+    b2Draw.useDrawingBounds = true;
+    b2Draw.drawShapes = true;
+    b2Draw.drawJoints = true;
+    b2Draw.drawBounds = false;
+    b2Draw.drawContacts = false;
+    b2Draw.context = this;
+}
+
+void DebugDraw::setEnabled(bool value) {
+    if (enabled == value) return;
+    enabled = value;
+    if (!enabled) clear();
+    std::cout << "DebugDraw: " << (enabled ? "enabled" : "disabled") << std::endl;
+}
+
+DebugDraw::Batch& DebugDraw::getBatch(SDL_Color color) {
+    uint32_t key = (uint32_t(color.r) << 24) | (uint32_t(color.g) << 16) | (uint32_t(color.b) << 8) | color.a;
+    auto it = batchIndex.find(key);
+    if (it != batchIndex.end()) return batches[it->second];
+
+    batchIndex[key] = batches.size();
+    batches.push_back(Batch{});
+    batches.back().color = color;
+    return batches.back();
+}
+
+SDL_Color DebugDraw::fromHex(b2HexColor color) {
+    uint32_t c = uint32_t(color);
+    return SDL_Color{Uint8((c >> 16) & 0xFF), Uint8((c >> 8) & 0xFF), Uint8(c & 0xFF), 255};
+}
+
+void DebugDraw::beginPolyline(Batch& batch, float x, float y) {
+    batch.lineStarts.push_back((int)batch.linePoints.size());
+    batch.linePoints.push_back(SDL_FPoint{x, y});
+}
+
+void DebugDraw::extendPolyline(Batch& batch, float x, float y) {
+    batch.linePoints.push_back(SDL_FPoint{x, y});
+}
+
+void DebugDraw::addLine(float x1, float y1, float x2, float y2, SDL_Color color) {
+    if (!enabled) return;
+    Batch& batch = getBatch(color);
+
+    // Segments that continue the previous one join its polyline (one DrawLines call for both)
+    bool continues = !batch.lineStarts.empty() &&
+                     batch.linePoints.back().x == x1 && batch.linePoints.back().y == y1;
+    if (!continues) beginPolyline(batch, x1, y1);
+    extendPolyline(batch, x2, y2);
+}
+
+void DebugDraw::addRect(const SDL_FRect& rect, SDL_Color color) {
+    if (!enabled) return;
+    getBatch(color).rects.push_back(rect);
+}
+
+void DebugDraw::addFilledRect(const SDL_FRect& rect, SDL_Color color) {
+    if (!enabled) return;
+    getBatch(color).filledRects.push_back(rect);
+}
+
+void DebugDraw::addPoint(float x, float y, SDL_Color color) {
+    if (!enabled) return;
+    getBatch(color).points.push_back(SDL_FPoint{x, y});
+}
+
+void DebugDraw::drawWorld(b2WorldId worldId, const View& view, float worldHeight) {
+    if (!enabled || !B2_IS_NON_NULL(worldId)) return;
+    this->worldHeight = worldHeight;
+
+    // Only shapes overlapping the screen (Box2D coordinates are Y-up)
+    float viewW = view.screenWidth / view.scale;
+    float viewH = view.screenHeight / view.scale;
+    b2Draw.drawingBounds.lowerBound = b2Vec2{view.x, worldHeight - (view.y + viewH)};
+    b2Draw.drawingBounds.upperBound = b2Vec2{view.x + viewW, worldHeight - view.y};
+
+    b2World_Draw(worldId, &b2Draw);
+}
+
+void DebugDraw::swapBuffers() {
+    std::swap(batches, drawBatches);
+    std::swap(batchIndex, drawIndex);
+    clear();
+}
+
+void DebugDraw::flush(const View& view) {
+    if (!renderer) return;
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+
+    for (Batch& batch : drawBatches) {
+        SDL_SetRenderDrawColor(renderer, batch.color.r, batch.color.g, batch.color.b, batch.color.a);
+
+        if (!batch.linePoints.empty()) {
+            scratch.resize(batch.linePoints.size());
+            for (size_t i = 0; i < batch.linePoints.size(); ++i) {
+                scratch[i].x = (batch.linePoints[i].x - view.x) * view.scale;
+                scratch[i].y = (batch.linePoints[i].y - view.y) * view.scale;
+            }
+            for (size_t i = 0; i < batch.lineStarts.size(); ++i) {
+                int start = batch.lineStarts[i];
+                int end = (i + 1 < batch.lineStarts.size()) ? batch.lineStarts[i + 1] : (int)scratch.size();
+                SDL_RenderDrawLinesF(renderer, &scratch[start], end - start);
+            }
+        }
+
+        auto transformRects = [&](const std::vector<SDL_FRect>& rects) {
+            scratchRects.resize(rects.size());
+            for (size_t i = 0; i < rects.size(); ++i) {
+                scratchRects[i] = SDL_FRect{(rects[i].x - view.x) * view.scale, (rects[i].y - view.y) * view.scale,
+                                            rects[i].w * view.scale, rects[i].h * view.scale};
+            }
+        };
+        if (!batch.filledRects.empty()) {
+            transformRects(batch.filledRects);
+            SDL_RenderFillRectsF(renderer, scratchRects.data(), (int)scratchRects.size());
+        }
+        if (!batch.rects.empty()) {
+            transformRects(batch.rects);
+            SDL_RenderDrawRectsF(renderer, scratchRects.data(), (int)scratchRects.size());
+        }
+
+        if (!batch.points.empty()) {
+            scratch.resize(batch.points.size());
+            for (size_t i = 0; i < batch.points.size(); ++i) {
+                scratch[i].x = (batch.points[i].x - view.x) * view.scale;
+                scratch[i].y = (batch.points[i].y - view.y) * view.scale;
+            }
+            SDL_RenderDrawPointsF(renderer, scratch.data(), (int)scratch.size());
+        }
+    }
+
+    clearBatches(drawBatches);
+}
+
+void DebugDraw::clear() {
+    clearBatches(batches);
+}
+
+void DebugDraw::clearBatches(std::vector<Batch>& batches) {
+    // Keep the batches (and their capacity) so the next frame does not reallocate
+    for (Batch& batch : batches) {
+        batch.linePoints.clear();
+        batch.lineStarts.clear();
+        batch.rects.clear();
+        batch.filledRects.clear();
+        batch.points.clear();
+    }
+}
+
+void DebugDraw::addCircleOutline(b2Vec2 center, float radius, SDL_Color color) {
+    const int segments = 16;
+    Batch& batch = getBatch(color);
+    SDL_FPoint c = toWorld(center);
+    beginPolyline(batch, c.x + radius, c.y);
+    for (int i = 1; i <= segments; ++i) {
+        float a = 2.0f * B2_PI * i / segments;
+        extendPolyline(batch, c.x + radius * std::cos(a), c.y + radius * std::sin(a));
+    }
+}
+
+// Box2D callbacks
+
+void DebugDraw::drawPolygon(const b2Vec2* vertices, int vertexCount, b2HexColor color, void* context) {
+    DebugDraw* self = static_cast<DebugDraw*>(context);
+    if (vertexCount <= 0) return;
+    Batch& batch = self->getBatch(fromHex(color));
+
+    SDL_FPoint first = self->toWorld(vertices[0]);
+    self->beginPolyline(batch, first.x, first.y);
+    for (int i = 1; i < vertexCount; ++i) {
+        SDL_FPoint p = self->toWorld(vertices[i]);
+        self->extendPolyline(batch, p.x, p.y);
+    }
+    self->extendPolyline(batch, first.x, first.y);
+}
+
+void DebugDraw::drawSolidPolygon(b2Transform transform, const b2Vec2* vertices, int vertexCount, float radius,
+                                 b2HexColor color, void* context) {
+    // Outline only; rounded corners are not worth the extra points for a debug view
+    (void)radius;
+    DebugDraw* self = static_cast<DebugDraw*>(context);
+    if (vertexCount <= 0) return;
+    Batch& batch = self->getBatch(fromHex(color));
+
+    SDL_FPoint first = self->toWorld(b2TransformPoint(transform, vertices[0]));
+    self->beginPolyline(batch, first.x, first.y);
+    for (int i = 1; i < vertexCount; ++i) {
+        SDL_FPoint p = self->toWorld(b2TransformPoint(transform, vertices[i]));
+        self->extendPolyline(batch, p.x, p.y);
+    }
+    self->extendPolyline(batch, first.x, first.y);
+}
+
+void DebugDraw::drawCircle(b2Vec2 center, float radius, b2HexColor color, void* context) {
+    static_cast<DebugDraw*>(context)->addCircleOutline(center, radius, fromHex(color));
+}
+
+void DebugDraw::drawSolidCircle(b2Transform transform, float radius, b2HexColor color, void* context) {
+    DebugDraw* self = static_cast<DebugDraw*>(context);
+    SDL_Color c = fromHex(color);
+    self->addCircleOutline(transform.p, radius, c);
+
+    // Radius line shows the rotation
+    b2Vec2 edge = b2TransformPoint(transform, b2Vec2{radius, 0.0f});
+    SDL_FPoint p1 = self->toWorld(transform.p);
+    SDL_FPoint p2 = self->toWorld(edge);
+    self->addLine(p1.x, p1.y, p2.x, p2.y, c);
+}
+
+void DebugDraw::drawSolidCapsule(b2Vec2 p1, b2Vec2 p2, float radius, b2HexColor color, void* context) {
+    DebugDraw* self = static_cast<DebugDraw*>(context);
+    SDL_Color c = fromHex(color);
+    self->addCircleOutline(p1, radius, c);
+    self->addCircleOutline(p2, radius, c);
+
+    // Side edges
+    b2Vec2 axis = b2Normalize(b2Sub(p2, p1));
+    b2Vec2 offset = b2MulSV(radius, b2Vec2{-axis.y, axis.x});
+    SDL_FPoint left1 = self->toWorld(b2Add(p1, offset)), left2 = self->toWorld(b2Add(p2, offset));
+    SDL_FPoint right1 = self->toWorld(b2Sub(p1, offset)), right2 = self->toWorld(b2Sub(p2, offset));
+    self->addLine(left1.x, left1.y, left2.x, left2.y, c);
+    self->addLine(right1.x, right1.y, right2.x, right2.y, c);
+}
+
+void DebugDraw::drawSegment(b2Vec2 p1, b2Vec2 p2, b2HexColor color, void* context) {
+    DebugDraw* self = static_cast<DebugDraw*>(context);
+    SDL_FPoint a = self->toWorld(p1);
+    SDL_FPoint b = self->toWorld(p2);
+    self->addLine(a.x, a.y, b.x, b.y, fromHex(color));
+}
+
+void DebugDraw::drawTransform(b2Transform transform, void* context) {
+    DebugDraw* self = static_cast<DebugDraw*>(context);
+    const float axisLength = 16.0f; // pixels
+    SDL_FPoint origin = self->toWorld(transform.p);
+    SDL_FPoint xAxis = self->toWorld(b2TransformPoint(transform, b2Vec2{axisLength, 0.0f}));
+    SDL_FPoint yAxis = self->toWorld(b2TransformPoint(transform, b2Vec2{0.0f, axisLength}));
+    self->addLine(origin.x, origin.y, xAxis.x, xAxis.y, SDL_Color{255, 0, 0, 255});
+    self->addLine(origin.x, origin.y, yAxis.x, yAxis.y, SDL_Color{0, 255, 0, 255});
+}
+
+void DebugDraw::drawPoint(b2Vec2 p, float size, b2HexColor color, void* context) {
+    DebugDraw* self = static_cast<DebugDraw*>(context);
+    SDL_FPoint w = self->toWorld(p);
+    if (size <= 1.0f) {
+        self->addPoint(w.x, w.y, fromHex(color));
+    } else {
+        self->addFilledRect(SDL_FRect{w.x - size / 2.0f, w.y - size / 2.0f, size, size}, fromHex(color));
+    }
+}
+
+void DebugDraw::drawString(b2Vec2 p, const char* s, b2HexColor color, void* context) {
+    // No text rendering in the debug layer
+    (void)p; (void)s; (void)color; (void)context;
+}
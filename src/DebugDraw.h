@@ -0,0 +1,110 @@
+#pragma once
+#include <SDL.h>
+#include <box2d/box2d.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class View;
+
+/**
+ * DebugDraw - Batched line/rect/point overlay for physics and gameplay debugging
+ *
+ * Primitives are given in world coordinates (SDL Y-down) and collected into one
+ * batch per colour. flush() transforms them with the camera and issues a single
+ * SDL_RenderDrawLinesF/DrawRectsF/FillRectsF/DrawPointsF call per colour and
+ * primitive kind, instead of one draw call (and colour change) per shape.
+ *
+ * drawWorld() implements b2DebugDraw, so shapes, AABBs, contacts and joints come
+ * straight from b2World_Draw. Toggle at runtime with setEnabled()/toggle(); while
+ * disabled every add call returns immediately and nothing is drawn.
+ *
+ * The batches are double buffered: gameplay code fills one set while the render
+ * thread draws the other. swapBuffers() hands the collected set over.
+ */
+class DebugDraw {
+public:
+    DebugDraw();
+
+    void setRenderer(SDL_Renderer* renderer) { this->renderer = renderer; }
+
+    bool isEnabled() const { return enabled; }
+    void setEnabled(bool value);
+    void toggle() { setEnabled(!enabled); }
+
+    // Which parts of the Box2D world drawWorld() shows
+    void setDrawShapes(bool value) { b2Draw.drawShapes = value; }
+    void setDrawBounds(bool value) { b2Draw.drawBounds = value; }
+    void setDrawContacts(bool value) { b2Draw.drawContacts = value; }
+    void setDrawJoints(bool value) { b2Draw.drawJoints = value; }
+
+    // Queue primitives (world coordinates)
+    void addLine(float x1, float y1, float x2, float y2, SDL_Color color);
+    void addRect(const SDL_FRect& rect, SDL_Color color);
+    void addFilledRect(const SDL_FRect& rect, SDL_Color color);
+    void addPoint(float x, float y, SDL_Color color);
+
+    /**
+     * Queue the Box2D world's debug geometry through b2World_Draw
+     * @param worldId World to draw
+     * @param view Camera, used to skip shapes outside the screen
+     * @param worldHeight Height used by the Box2D Y-up <-> SDL Y-down conversion
+     */
+    void drawWorld(b2WorldId worldId, const View& view, float worldHeight);
+
+    // Make the primitives collected so far the set that flush() draws
+    void swapBuffers();
+
+    // Draw the swapped-in set with the given camera, then empty it (render thread)
+    void flush(const View& view);
+
+    // Drop collected primitives without drawing them
+    void clear();
+
+private:
+    // All primitives of one colour
+    struct Batch {
+        SDL_Color color;
+        std::vector<SDL_FPoint> linePoints;   // consecutive polylines, split by lineStarts
+        std::vector<int> lineStarts;
+        std::vector<SDL_FRect> rects;
+        std::vector<SDL_FRect> filledRects;
+        std::vector<SDL_FPoint> points;
+    };
+
+    Batch& getBatch(SDL_Color color);
+    static void clearBatches(std::vector<Batch>& batches);
+    static SDL_Color fromHex(b2HexColor color);
+
+    // Polylines: begin one, extend it, and it is drawn as a single DrawLines call
+    void beginPolyline(Batch& batch, float x, float y);
+    void extendPolyline(Batch& batch, float x, float y);
+
+    // Box2D callbacks (context is the DebugDraw)
+    static void drawPolygon(const b2Vec2* vertices, int vertexCount, b2HexColor color, void* context);
+    static void drawSolidPolygon(b2Transform transform, const b2Vec2* vertices, int vertexCount, float radius,
+                                 b2HexColor color, void* context);
+    static void drawCircle(b2Vec2 center, float radius, b2HexColor color, void* context);
+    static void drawSolidCircle(b2Transform transform, float radius, b2HexColor color, void* context);
+    static void drawSolidCapsule(b2Vec2 p1, b2Vec2 p2, float radius, b2HexColor color, void* context);
+    static void drawSegment(b2Vec2 p1, b2Vec2 p2, b2HexColor color, void* context);
+    static void drawTransform(b2Transform transform, void* context);
+    static void drawPoint(b2Vec2 p, float size, b2HexColor color, void* context);
+    static void drawString(b2Vec2 p, const char* s, b2HexColor color, void* context);
+
+    // Box2D (Y-up) to world (Y-down)
+    SDL_FPoint toWorld(b2Vec2 p) const { return SDL_FPoint{p.x, worldHeight - p.y}; }
+    void addCircleOutline(b2Vec2 center, float radius, SDL_Color color);
+
+    SDL_Renderer* renderer = nullptr;
+    bool enabled = false;
+    float worldHeight = 0.0f;
+    b2DebugDraw b2Draw;
+
+    std::vector<Batch> batches;                       // being collected
+    std::unordered_map<uint32_t, size_t> batchIndex;  // packed RGBA -> batches index
+    std::vector<Batch> drawBatches;                   // being drawn
+    std::unordered_map<uint32_t, size_t> drawIndex;
+    std::vector<SDL_FPoint> scratch;                 // screen-space points for one batch
+    std::vector<SDL_FRect> scratchRects;
+};
@@ -5,6 +5,8 @@
 #include <SDL_image.h>
 #include <iostream>
 #include <algorithm>
+#include <thread>
+#include <utility>
 #include <box2d/box2d.h>
 #include <box2d/collision.h>
 #include "InputDevice.h"
@@ -18,21 +20,90 @@
 #include "HealthComponent.h"
 #include "MissileComponent.h"
 #include "ImageDevice.h"
+#include "TextRenderer.h"
+#include "AnimationLibrary.h"
 
 Engine* Engine::E = nullptr;
 
-Engine::Engine() {
+Engine::Engine(const EngineConfig& config) : config(config) {
 
-    SDL_Init(SDL_INIT_VIDEO);
-    IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG);
-    width = 800;
-    height = 600;
-    window = SDL_CreateWindow("Engine", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, width, height, SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
-    SDL_GetWindowSize(window, &width, &height);
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    width = config.width;
+    height = config.height;
     E = this;
-    
 
+    if (config.headless) {
+        // No display needed: prefer the offscreen driver, fall back to dummy
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "offscreen");
+        if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+            SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+            if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+                std::cerr << "Engine: No headless video driver (" << SDL_GetError() << "), continuing without one" << std::endl;
+            }
+        }
+        IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG);
+
+        // Software renderer draws into a plain surface (also used to load textures)
+        headlessSurface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+        std::cout << "Engine: Headless mode (" << (SDL_GetCurrentVideoDriver() ? SDL_GetCurrentVideoDriver() : "no video driver")
+                  << ", rendering " << (config.render ? "on" : "off") << ")" << std::endl;
+    } else {
+        SDL_Init(SDL_INIT_VIDEO);
+        IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG);
+        window = SDL_CreateWindow("Engine", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, width, height, SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
+        SDL_GetWindowSize(window, &width, &height);
+    }
+
+    // With a render thread the renderer is created (and only ever used) on that thread
+    if (config.renderThread) {
+        renderThread.start([this]() { drawFrame(); });
+    }
+    renderThread.invoke([this]() {
+        if (headlessSurface) {
+            renderer = SDL_CreateSoftwareRenderer(headlessSurface);
+        } else if (window) {
+            // Only vsync when it does the pacing; otherwise the pacer and vsync would both throttle
+            Uint32 flags = SDL_RENDERER_ACCELERATED;
+            if (this->config.pacing == PacingMode::VSync) flags |= SDL_RENDERER_PRESENTVSYNC;
+            renderer = SDL_CreateRenderer(window, -1, flags);
+        }
+        if (!renderer) {
+            std::cerr << "Engine: Failed to create renderer: " << SDL_GetError() << std::endl;
+        } else if (this->config.pacing == PacingMode::VSync) {
+            SDL_RendererInfo info;
+            if (SDL_GetRendererInfo(renderer, &info) != 0 || !(info.flags & SDL_RENDERER_PRESENTVSYNC)) {
+                std::cout << "Engine: Renderer has no vsync, pacing at a fixed rate instead" << std::endl;
+                this->config.pacing = PacingMode::Fixed;
+            }
+        }
+        spriteBatch.setRenderer(renderer);
+        staticCache.setRenderer(renderer);
+        debugDraw.setRenderer(renderer);
+        particles.setRenderer(renderer);
+        resolutionScaler.setRenderer(renderer);
+        renderStats.setRenderer(renderer);
+        spriteBatch.setStats(&renderStats);
+        resolutionScaler.setBounds(this->config.minRenderScale, this->config.maxRenderScale);
+        resolutionScaler.setBudget(this->config.renderBudgetMs);
+    });
+
+    renderStats.setEnabled(this->config.renderStats);
+
+    particles.setCapacity(size_t(this->config.particleBudget));
+    int particleThreads = this->config.particleThreads;
+    if (particleThreads < 0) {
+        particleThreads = std::min(std::max(int(std::thread::hardware_concurrency()) - 1, 0), 3);
+    }
+    particles.setWorkerCount(unsigned(particleThreads));
+
+    ImageDevice::setMemoryBudget(size_t(this->config.textureBudgetMB) * 1024 * 1024);
+
+    // Small font for HUD labels
+    if (renderer) {
+        TextRenderer::loadFont("hud", TextRenderer::DEFAULT_FONT_PATH, 24);
+    }
+
+    framePacer.setTargetRate(this->config.targetFps);
+    framePacer.setMode(this->config.pacing);
     
     // Create Box2D world
     // Box2D uses Y-up coordinate system internally
@@ -43,24 +114,44 @@ Engine::Engine() {
     worldId = b2CreateWorld(&worldDef);
 }
 Engine::~Engine() {
+    // Tile collision bodies belong to the world, so they go first
+    tileMaps.clear();
+
     // Destroy Box2D world
     if (B2_IS_NON_NULL(worldId))
         b2DestroyWorld(worldId);
     
-    //ImageDevice::cleanup();
-    SDL_DestroyWindow(window);
-    SDL_DestroyRenderer(renderer);
+    // Let the last frame finish, then release renderer resources where they were created.
+    // Cached textures must go before the renderer that owns them
+    renderThread.waitForFrame();
+    renderThread.invoke([this]() {
+        staticCache.clear();
+        resolutionScaler.clear();
+        renderStats.clear();
+        if (freezeTexture) SDL_DestroyTexture(freezeTexture);
+        freezeTexture = nullptr;
+        TextRenderer::cleanup();
+        ImageDevice::cleanup();
+        if (renderer) SDL_DestroyRenderer(renderer);
+        renderer = nullptr;
+    });
+    renderThread.stop();
+
+    if (window) SDL_DestroyWindow(window);
+    if (headlessSurface) SDL_FreeSurface(headlessSurface);
     IMG_Quit();
     SDL_Quit();
 }
 
 Object* Engine::addObject() {
+    staticCache.invalidate();
     objects.push_back(std::make_unique<Object>());
     return objects.back().get();
 }
 
 void Engine::update() {
-    processInput();
+    dt = framePacer.getSmoothedDeltaTime();
+    // Events (input, quit, window state) are polled once per frame by the caller
     
     // Step physics world with fixed timestep (for consistent physics)
     if (B2_IS_NON_NULL(worldId)) {
@@ -73,28 +164,16 @@ void Engine::update() {
     }
     
     updateObjects();
+    particles.update(dt);
 
     debugPlayerPosition(player);
     // Update camera
     updateView(player);
-    render();
-}
-
-void Engine::processInput() {
-    SDL_Event event;
-    while (SDL_PollEvent(&event)) {
-        if (event.type == SDL_WINDOW_RESIZABLE){
-            width = event.window.data1;
-            height = event.window.data2;
-        }
-        if (event.type == SDL_QUIT) {
-            exit(0);
-        }
-        InputDevice::process(event);
-    }
 }
 
 void Engine::updateObjects() {
+    animationTime += dt;
+
     // Update all objects
     for (auto& obj : objects) 
         obj->update(this->dt); 
@@ -103,66 +182,184 @@ void Engine::updateObjects() {
 
 void Engine::render()
 {
-    if (!renderer) return;
+    if (!isRenderingEnabled()) return;
+    ImageDevice::beginFrame(); // textures drawn from here on count as used this frame
 
-    // Clear screen (black background)
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderClear(renderer);
+    // Dead: the world stops, so keep its last frame and queue only the overlay
+    if (isGameOver()) {
+        freezeFrame();
+        renderGameOver();
+        return;
+    }
 
-    // Render all objects
+    // Queue all sprites and the HUD (static scenery comes pre-rendered from the chunk cache)
+    submitParallaxLayers();
+    for (auto& map : tileMaps) {
+        map->submit(view, renderQueue);
+    }
+    staticCache.submit(objects, view, renderQueue);
     for (auto& obj : objects) {
-        obj->render();  // pass the camera view
-        BodyComponent* body = obj->getComponent<BodyComponent>();
-        // if (body) {
-        //     drawRect(body->getX(), body->getY(), body->getWidth(), body->getHeight(), 255, 0, 0, 150);
-        // }
+        obj->render();
     }
-    
-    // Draw raycast visualizations
-    for (const auto& ray : raycastVisuals) {
-        SDL_Rect startRect = view.transform(SDL_Rect{
-            int(ray.x1 - 3), int(ray.y1 - 3), 6, 6
-        });
-        SDL_Rect endRect = view.transform(SDL_Rect{
-            int(ray.x2 - 3), int(ray.y2 - 3), 6, 6
-        });
-        
-        SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255); // Yellow for ray
-        SDL_RenderFillRect(renderer, &startRect);
-        
-        if (ray.hit) {
-            SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255); // Red for hit point
-            // Convert Box2D Y-up coordinate to SDL Y-down coordinate
-            float hitY = view.worldHeight - ray.hitPoint.y;
-            SDL_Rect hitRect = view.transform(SDL_Rect{
-                int(ray.hitPoint.x - 5), int(hitY - 5), 10, 10
-            });
-            SDL_RenderFillRect(renderer, &hitRect);
+    particles.render(view);
+    renderHealthUI();
+
+    // Physics shapes, raycast and AABB query visualizations (when debug draw is on)
+    debugDrawObjects();
+}
+
+bool Engine::presentFrame()
+{
+    if (!isRenderingEnabled()) {
+        renderQueue.clear();
+        debugDraw.clear();
+        return true;
+    }
+
+    // A frozen frame only changes with its overlay
+    if (frozen) {
+        uint64_t signature = renderQueue.signature();
+        if (!frozenDirty && signature == frozenSignature) {
+            renderQueue.clear();
+            debugDraw.clear();
+            return false;
+        }
+        frozenSignature = signature;
+        frozenDirty = false;
+    }
+
+    // The previous snapshot must be fully drawn before it is reused
+    renderThread.waitForFrame();
+
+    std::swap(renderQueue, frameQueue);
+    renderQueue.clear();
+    debugDraw.swapBuffers();
+    particles.swapBuffers();
+    frameView = view;
+    frameFrozen = frozen;
+
+    // Draws on the render thread, or right here when there is none
+    if (renderThread.isRunning()) {
+        renderThread.submitFrame();
+    } else {
+        drawFrame();
+    }
+    return true;
+}
+
+void Engine::freezeFrame()
+{
+    if (frozen) return;
+    frozen = true;
+    frozenDirty = true;
+    if (!isRenderingEnabled()) return;
+
+    // The last snapshot is still intact until the next presentFrame()
+    renderThread.waitForFrame();
+    runOnRenderThread([this]() { captureFreezeFrame(); });
+}
+
+void Engine::captureFreezeFrame()
+{
+    int w = 0, h = 0;
+    if (SDL_GetRendererOutputSize(renderer, &w, &h) != 0 || !SDL_RenderTargetSupported(renderer)) return;
+
+    if (!freezeTexture || freezeWidth != w || freezeHeight != h) {
+        if (freezeTexture) SDL_DestroyTexture(freezeTexture);
+        freezeTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, w, h);
+        if (!freezeTexture) {
+            std::cerr << "Engine: Failed to create freeze-frame texture: " << SDL_GetError() << std::endl;
+            return;
+        }
+        SDL_SetTextureBlendMode(freezeTexture, SDL_BLENDMODE_NONE);
+        freezeWidth = w;
+        freezeHeight = h;
+    }
+
+    // Same passes as drawFrame() at native resolution, minus the debug overlay
+    SDL_SetRenderTarget(renderer, freezeTexture);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    if (!frameFrozen) {
+        frameQueue.dispatch(spriteBatch, RenderLayer::Background, RenderLayer::HUD);
+        spriteBatch.flush();
+        particles.flush();
+    }
+    SDL_SetRenderTarget(renderer, nullptr);
+}
+
+void Engine::drawFrame()
+{
+    // Frozen: the captured frame and the overlay queued on top of it
+    if (frameFrozen) {
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        if (freezeTexture) {
+            SDL_RenderCopy(renderer, freezeTexture, nullptr, nullptr);
         } else {
-            SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255); // Green for no hit
+            SDL_RenderClear(renderer);
         }
-        SDL_RenderFillRect(renderer, &endRect);
-        
-        // Draw line
-        SDL_SetRenderDrawColor(renderer, 255, 255, 0, 128);
-        SDL_Point start = {int(ray.x1 - view.x), int(ray.y1 - view.y)};
-        SDL_Point end = {int(ray.x2 - view.x), int(ray.y2 - view.y)};
-        SDL_RenderDrawLine(renderer, start.x, start.y, end.x, end.y);
+        frameQueue.dispatch(spriteBatch, RenderLayer::Background, RenderLayer::HUD);
+        spriteBatch.flush();
+        SDL_RenderPresent(renderer);
+        return;
     }
-    
-    // Draw AABB query visualizations
-    for (const auto& aabb : aabbQueryVisuals) {
-        drawRect(aabb.x, aabb.y, aabb.w, aabb.h, 0, 255, 255, 100); // Cyan outline
+
+    // Overdraw heatmap replaces the frame (and is not counted)
+    if (renderStats.isHeatmapEnabled() && renderStats.beginHeatmap()) {
+        SDL_Texture* white = ImageDevice::getWhiteTexture();
+        frameQueue.dispatchCoverage(spriteBatch, RenderLayer::Background, RenderLayer::HUD, white, RenderStats::HEAT_STEP);
+        particles.drawCoverage(spriteBatch, white, RenderStats::HEAT_STEP);
+        renderStats.endHeatmap();
+        SDL_RenderPresent(renderer);
+        return;
     }
 
-    // Optional: draw the ground line
-    drawRect(0, groundY, view.worldWidth, 2, 0, 255, 0);
+    Uint64 drawStart = SDL_GetPerformanceCounter();
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+
+    int outputW = width, outputH = height;
+    SDL_GetRendererOutputSize(renderer, &outputW, &outputH);
+    renderStats.beginFrame(outputW, outputH);
+
+    // World layers, particles and debug overlay at the internal resolution
+    resolutionScaler.beginWorld();
+    renderStats.setPixelScale(resolutionScaler.getActiveScale());
+    frameQueue.dispatch(spriteBatch, RenderLayer::Background, RenderLayer::Foreground);
+    spriteBatch.flush();
+    particles.flush();
+    debugDraw.flush(frameView);
+    if (renderStats.isCounting()) {
+        particles.countStats(renderStats);
+        if (resolutionScaler.getActiveScale() < 1.0f) {
+            renderStats.addPixels(StatCategory::Composite, 1, uint64_t(outputW) * uint64_t(outputH));
+            renderStats.countDrawCall(StatCategory::Composite);
+        }
+    }
+    resolutionScaler.endWorld();
+
+    // HUD and text on top at native resolution
+    renderStats.setPixelScale(1.0f);
+    frameQueue.dispatch(spriteBatch, RenderLayer::HUD, RenderLayer::HUD);
+    spriteBatch.flush();
+
+    if (renderStats.isCounting()) {
+        for (RenderLayer layer : {RenderLayer::Background, RenderLayer::World, RenderLayer::Foreground, RenderLayer::HUD}) {
+            renderStats.countCulled(StatCategory(layer), frameQueue.getCulled(layer));
+        }
+    }
+    renderStats.endFrame();
 
-    // Note: Health UI and Game Over are rendered in main.cpp's render loop
-    // Present the final frame
+    // Measured before present, which may wait for vsync
+    double drawMs = (SDL_GetPerformanceCounter() - drawStart) * 1000.0 / double(SDL_GetPerformanceFrequency());
+    resolutionScaler.recordFrame(drawMs);
     SDL_RenderPresent(renderer);
 }
 
+void Engine::runOnRenderThread(const std::function<void()>& task)
+{
+    renderThread.invoke(task);
+}
+
 void Engine::setView(int x, int y) {
     view.x = x;
     view.y = y;
@@ -194,51 +391,61 @@ void Engine::drawRect(float x, float y, float w, float h, int r, int g, int b, i
     // Apply camera transform
     rect = view.transform(rect);
 
-    // Draw the rectangle
-    SDL_SetRenderDrawColor(renderer, r, g, b, a);
-    SDL_RenderFillRect(renderer, &rect);
+    // Queued over the world sprites; the shared white texture lets consecutive rects batch together
+    SDL_Texture* white = ImageDevice::getWhiteTexture();
+    if (!white) return;
+    SDL_FRect dst = {float(rect.x), float(rect.y), float(rect.w), float(rect.h)};
+    renderQueue.submit(RenderLayer::Foreground, RenderQueue::DEFAULT_WORLD_DEPTH, 0.0f, white, nullptr, dst,
+                       0.0f, SDL_FLIP_NONE, SDL_Color{Uint8(r), Uint8(g), Uint8(b), Uint8(a)});
 }
 
-void Engine::drawImage(std::string textureName, float x, float y, float w, float h, float angle, bool centerOrigin ) {
-    SDL_Texture* tex = ImageDevice::get(textureName);
-    SDL_Rect rect;
-    SDL_Point* pCenter = nullptr;
-    
+void Engine::drawImage(const std::string& textureName, float x, float y, float w, float h, float angle, bool centerOrigin ) {
+    drawImage(ImageDevice::getHandle(textureName), x, y, w, h, angle, centerOrigin);
+}
+
+void Engine::drawImage(TextureHandle texture, float x, float y, float w, float h, float angle, bool centerOrigin ) {
+    SDL_Texture* tex = ImageDevice::get(texture);
+    if (!tex) return;
+
+    // Rotation is always around the centre of the destination rect
+    SDL_FRect rect;
     if (centerOrigin) {
-        rect = {(int)(x - view.x - w / 2), (int)(y - view.y - h / 2), (int)w, (int)h};
-        static SDL_Point centerPoint; 
-        centerPoint = {(int)(w/2), (int)(h/2)};
-        pCenter = &centerPoint;
+        rect = {x - view.x - w / 2, y - view.y - h / 2, w, h};
     } else {
-        rect = {(int)(x - view.x), (int)(y - view.y), (int)w, (int)h};
-        pCenter = nullptr; // top-left origin
+        rect = {x - view.x, y - view.y, w, h}; // top-left origin
     }
 
-    SDL_RenderCopyEx(renderer, tex, nullptr, &rect, angle, pCenter, SDL_FLIP_NONE);
+    renderQueue.submit(RenderLayer::World, RenderQueue::DEFAULT_WORLD_DEPTH, rect.y + rect.h,
+                       tex, ImageDevice::getRegion(texture), rect, angle);
 }
 
 void Engine::debugDrawObjects() {
-    if (!renderer) return;
-
-    SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255); // bright green
-
-    for (auto& obj : objects) {
-        BodyComponent* body = obj->getComponent<BodyComponent>();
-        if (!body) continue;
+    if (!renderer || !debugDraw.isEnabled()) return;
 
-        // World rectangle
-        SDL_Rect worldRect = {
-            int(body->getX()),
-            int(body->getY()),
-            int(body->getWidth()),
-            int(body->getHeight())
-        };
+    // Shapes, AABBs, contacts and joints straight from Box2D
+    debugDraw.drawWorld(worldId, view, float(view.worldHeight));
 
-        // Transform with camera
-        SDL_Rect screenRect = view.transform(worldRect);
+    // Recent raycasts: yellow line and start, red hit point, green end when nothing was hit
+    const SDL_Color yellow{255, 255, 0, 255};
+    for (const auto& ray : raycastVisuals) {
+        debugDraw.addLine(ray.x1, ray.y1, ray.x2, ray.y2, yellow);
+        debugDraw.addFilledRect(SDL_FRect{ray.x1 - 3, ray.y1 - 3, 6, 6}, yellow);
+        if (ray.hit) {
+            // Convert Box2D Y-up coordinate to SDL Y-down coordinate
+            float hitY = box2DToSDLY(ray.hitPoint.y);
+            debugDraw.addFilledRect(SDL_FRect{ray.hitPoint.x - 5, hitY - 5, 10, 10}, SDL_Color{255, 0, 0, 255});
+            debugDraw.addFilledRect(SDL_FRect{ray.x2 - 3, ray.y2 - 3, 6, 6}, SDL_Color{255, 0, 0, 255});
+        } else {
+            debugDraw.addFilledRect(SDL_FRect{ray.x2 - 3, ray.y2 - 3, 6, 6}, SDL_Color{0, 255, 0, 255});
+        }
+    }
 
-        SDL_RenderDrawRect(renderer, &screenRect);
+    // Recent AABB queries
+    for (const auto& aabb : aabbQueryVisuals) {
+        debugDraw.addRect(SDL_FRect{aabb.x, aabb.y, aabb.w, aabb.h}, SDL_Color{0, 255, 255, 255});
     }
+
+    // Drawn over the world and under the HUD when the frame is presented
 }
 
 void Engine::debugPlayerPosition(Object* player) {
@@ -286,6 +493,8 @@ void Engine::update(float dt) {
         processContactEvents();
     }
     
+    animationTime += dt;
+
     // Handle interactive physics controls
     handlePhysicsControls();
     
@@ -672,6 +881,7 @@ Object* Engine::createStaticBody(float x, float y, float w, float h) {
 
 void Engine::removeObject(Object* obj) {
     if (!obj) return;
+    staticCache.invalidate();
     
     // Find and remove from objects vector
     objects.erase(
@@ -691,12 +901,45 @@ void Engine::queueLevelLoad(const std::string& levelPath) {
     queuedLevelPath = levelPath;
     hasQueuedLevel = true;
     std::cout << "[ENGINE] Level load queued: " << levelPath << std::endl;
+
+    // Decoding starts now, so the swap next frame mostly waits for uploads
+    prefetchLevelTextures(levelPath);
+}
+
+std::vector<std::string> Engine::levelTextureNames(const std::string& levelPath) const {
+    std::vector<std::string> names = LevelLoader::collectTextures(levelPath);
+    names.push_back("heart"); // health HUD
+    return names;
+}
+
+void Engine::prefetchLevelTextures(const std::string& levelPath) {
+    if (levelPath == residentLevel) return;
+    ImageDevice::prefetch(levelTextureNames(levelPath));
+}
+
+void Engine::requireLevelTextures(const std::string& levelPath) {
+    if (levelPath == residentLevel) return;
+
+    // The new set is held before the old one is let go, so textures the levels share stay resident
+    std::vector<TextureHandle> required = ImageDevice::require(levelTextureNames(levelPath));
+    ImageDevice::release(levelTextures);
+    levelTextures = std::move(required);
+    residentLevel = levelPath;
+
+    // Clips defined before their sheets were resident, and cached scenery drawn from evicted textures
+    AnimationLibrary::resolvePending();
+    staticCache.invalidate();
+    std::cout << "[ENGINE] " << levelTextures.size() << " textures resident for " << levelPath << ", "
+              << ImageDevice::getMemoryUsage() / (1024 * 1024) << " MB in use" << std::endl;
 }
 
 void Engine::loadLevel(const std::string& levelPath) {
     std::cout << "[ENGINE] ========================================" << std::endl;
     std::cout << "[ENGINE] Loading level: " << levelPath << std::endl;
     
+    // Textures first, while the old level can still draw
+    requireLevelTextures(levelPath);
+
     // Clear bee damage cooldowns first
     beeDamageCooldown.clear();
     
@@ -704,13 +947,16 @@ void Engine::loadLevel(const std::string& levelPath) {
     // Important: Clear objects before loading new ones to avoid conflicts
     int oldObjectCount = objects.size();
     objects.clear();
+    particles.clear();
     player = nullptr;
     std::cout << "[ENGINE] Cleared " << oldObjectCount << " old objects" << std::endl;
     
+    // Set world size (you may want to make this configurable per level)
+    // before loading: bodies are converted to Box2D with the world height
+    setWorldSize(5000, 1200);
+
     // Load the new level
     if (LevelLoader::load(levelPath, *this)) {
-        // Set world size (you may want to make this configurable per level)
-        setWorldSize(5000, 1200);
         std::cout << "[ENGINE] Level loaded successfully: " << levelPath << std::endl;
         std::cout << "[ENGINE] New object count: " << objects.size() << std::endl;
         
@@ -741,6 +987,48 @@ void Engine::loadLevel(const std::string& levelPath) {
     }
 }
 
+void Engine::addParallaxLayer(const ParallaxLayer& layer) {
+    // Stable insert by factor so equal factors keep XML order
+    auto it = std::upper_bound(parallaxLayers.begin(), parallaxLayers.end(), layer,
+        [](const ParallaxLayer& a, const ParallaxLayer& b) { return a.factor < b.factor; });
+    it = parallaxLayers.insert(it, layer);
+    if (it->texture == INVALID_TEXTURE) it->texture = ImageDevice::getHandle(it->textureName);
+}
+
+TileMap* Engine::addTileMap(std::unique_ptr<TileMap> map) {
+    tileMaps.push_back(std::move(map));
+    return tileMaps.back().get();
+}
+
+bool Engine::overlapsSolidTile(float x, float y, float w, float h) const {
+    for (const auto& map : tileMaps) {
+        if (map->overlapsSolid(x, y, w, h)) return true;
+    }
+    return false;
+}
+
+void Engine::setOverdrawHeatmap(bool enabled) {
+    // Created here so the render thread never has to create it mid-frame
+    if (enabled) ImageDevice::getWhiteTexture();
+    renderStats.setHeatmapEnabled(enabled);
+}
+
+void Engine::submitParallaxLayers() {
+    // Start at the nearest layer that fully hides everything behind it
+    size_t first = 0;
+    for (size_t i = parallaxLayers.size(); i-- > 0; ) {
+        if (parallaxLayers[i].coversScreen(view)) {
+            first = i;
+            break;
+        }
+    }
+
+    renderQueue.countCulled(RenderLayer::Background, uint32_t(first));
+    for (size_t i = first; i < parallaxLayers.size(); ++i) {
+        parallaxLayers[i].submit(view, renderQueue);
+    }
+}
+
 void Engine::renderHealthUI() {
     if (!player) return;
     
@@ -756,60 +1044,60 @@ void Engine::renderHealthUI() {
     const int startX = 20;
     const int startY = 50;
     
-    SDL_Texture* heartTex = ImageDevice::get("heart");
+    // Resolved once; a missing heart image draws the fallback instead of failing every frame
+    if (heartTexture == INVALID_TEXTURE) heartTexture = ImageDevice::getHandle("heart");
+    SDL_Texture* heartTex = ImageDevice::get(heartTexture);
     if (!heartTex) return;
+    const SDL_Rect* heartSrc = ImageDevice::getRegion(heartTexture);
     
     // Draw hearts (screen space, not affected by camera)
-    // Reset texture color mod first to ensure clean state
-    SDL_SetTextureColorMod(heartTex, 255, 255, 255);
-    
+    // Darkening uses vertex colour, so all hearts share one batch
+    // Queued on the HUD layer, so they land on top of the world whenever this is called
     for (int i = 0; i < maxHealth; i++) {
-        SDL_Rect heartRect;
-        heartRect.x = startX + i * (heartSize + heartSpacing);
-        heartRect.y = startY;
-        heartRect.w = heartSize;
-        heartRect.h = heartSize;
+        SDL_FRect heartRect;
+        heartRect.x = float(startX + i * (heartSize + heartSpacing));
+        heartRect.y = float(startY);
+        heartRect.w = float(heartSize);
+        heartRect.h = float(heartSize);
         
         // Draw filled heart if player has this life, otherwise draw empty/dark
-        if (i < currentHealth) {
-            // Full color heart
-            SDL_SetTextureColorMod(heartTex, 255, 255, 255);
-            SDL_RenderCopy(renderer, heartTex, nullptr, &heartRect);
-        } else {
-            // Draw darkened heart
-            SDL_SetTextureColorMod(heartTex, 100, 100, 100); // Darken
-            SDL_RenderCopy(renderer, heartTex, nullptr, &heartRect);
-        }
+        SDL_Color tint = (i < currentHealth) ? SDL_Color{255, 255, 255, 255}
+                                             : SDL_Color{100, 100, 100, 255};
+        renderQueue.submit(RenderLayer::HUD, 0, heartRect.y + heartRect.h,
+                           heartTex, heartSrc, heartRect, 0.0f, SDL_FLIP_NONE, tint);
     }
-    
-    // Reset texture color mod after rendering
-    SDL_SetTextureColorMod(heartTex, 255, 255, 255);
+}
+
+void Engine::fillScreenRect(RenderLayer layer, uint16_t depth, const SDL_Rect& rect, SDL_Color color) {
+    SDL_Texture* white = ImageDevice::getWhiteTexture();
+    if (!white) return;
+    SDL_FRect dst = {float(rect.x), float(rect.y), float(rect.w), float(rect.h)};
+    renderQueue.submit(layer, depth, 0.0f, white, nullptr, dst, 0.0f, SDL_FLIP_NONE, color);
 }
 
 void Engine::renderGameOver() {
-    if (!renderer) return;
-    
-    // Draw semi-transparent overlay
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180);
-    SDL_Rect overlay = {0, 0, width, height};
-    SDL_RenderFillRect(renderer, &overlay);
-    
-    // Note: For text rendering, you would need SDL_ttf
-    // For now, we'll use simple rectangles to represent text/button
-    // You can enhance this later with actual text rendering
+    // Semi-transparent overlay over the whole world; it is the last world draw, so it
+    // stays at the internal resolution instead of costing a native full-screen blend
+    fillScreenRect(RenderLayer::Foreground, 0xFFFF, SDL_Rect{0, 0, width, height}, SDL_Color{0, 0, 0, 180});
+
+    // Banner, button and labels are queued on the HUD layer above the hearts (depth 0)
     
-    // "Game Over" text area (represented as a rectangle for now)
-    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-    SDL_Rect gameOverRect = {width / 2 - 100, height / 2 - 100, 200, 50};
-    SDL_RenderFillRect(renderer, &gameOverRect);
+    // "Game Over" banner
+    fillScreenRect(RenderLayer::HUD, 101, SDL_Rect{width / 2 - 100, height / 2 - 100, 200, 50}, SDL_Color{255, 0, 0, 255});
     
     // "Try Again" button
-    SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-    SDL_Rect buttonRect = {width / 2 - 75, height / 2, 150, 40};
-    SDL_RenderFillRect(renderer, &buttonRect);
-    
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    fillScreenRect(RenderLayer::HUD, 101, SDL_Rect{width / 2 - 75, height / 2, 150, 40}, SDL_Color{0, 255, 0, 255});
+
+    // Labels from the glyph atlas
+    if (TextRenderer::hasFont("hud")) {
+        const SDL_Color white = {255, 255, 255, 255};
+        const SDL_Color black = {0, 0, 0, 255};
+        int lineHeight = TextRenderer::measure("hud", "GAME OVER").y;
+        TextRenderer::draw("hud", "GAME OVER", width / 2.0f, height / 2.0f - 75 - lineHeight / 2.0f,
+                           white, TextAlign::Center, RenderLayer::HUD, 102);
+        TextRenderer::draw("hud", "Try Again", width / 2.0f, height / 2.0f + 20 - lineHeight / 2.0f,
+                           black, TextAlign::Center, RenderLayer::HUD, 102);
+    }
 }
 
 bool Engine::isGameOver() const {
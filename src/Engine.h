@@ -2,16 +2,29 @@
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include <functional>
 #include <SDL.h>
 #include <box2d/box2d.h>
 #include "Object.h"
 #include "View.h"
+#include "SpriteBatch.h"
+#include "RenderQueue.h"
+#include "StaticChunkCache.h"
+#include "ParallaxLayer.h"
+#include "TileMap.h"
+#include "DebugDraw.h"
+#include "EngineConfig.h"
+#include "RenderThread.h"
+#include "FramePacer.h"
+#include "ParticleSystem.h"
+#include "ResolutionScaler.h"
+#include "RenderStats.h"
 
 class Engine {
 public:
         static Engine* E;
         View& getView() { return view; }
-        Engine();
+        Engine(const EngineConfig& config = EngineConfig());
         ~Engine();
     
         // Core engine methods
@@ -20,8 +33,50 @@ public:
         //void getView() {return view};
         void update();
         void update(float dt);
-        void render(const View& view);
+
+        // Queue the gameplay frame (world, HUD, debug overlay, game over screen)
+        void render();
+        // Hand everything queued this frame to the renderer (render thread or inline)
+        // @return false when a frozen frame was unchanged and nothing was drawn
+        bool presentFrame();
+
+        /**
+         * Freeze-frame for pause, game over and menus: the last drawn gameplay frame
+         * is captured into a texture, and until unfreeze() each frame shows that
+         * texture with only what is queued on top (the overlay). Frames whose queue
+         * is identical to the previous one are not drawn or presented at all.
+         */
+        void freezeFrame();
+        void unfreeze() { frozen = false; }
+        bool isFrozen() const { return frozen; }
+        // Draw the frozen frame again (window exposed or resized)
+        void invalidateFrozenFrame() { frozenDirty = true; }
+        // Run renderer work (texture uploads, render targets) where the renderer lives
+        void runOnRenderThread(const std::function<void()>& task);
+        // Let the frame in flight finish; call before destroying anything it may still draw
+        void waitForFrame() { renderThread.waitForFrame(); }
+        bool hasRenderThread() const { return renderThread.isRunning(); }
+
+        // Frame timing; update() uses its smoothed dt
+        FramePacer& getFramePacer() { return framePacer; }
+        float getDeltaTime() const { return dt; }
+        // Game time in seconds, advanced only while objects update (animations are evaluated against it)
+        double getAnimationTime() const { return animationTime; }
+
         SDL_Renderer* getRenderer(){return renderer;}
+        const EngineConfig& getConfig() const { return config; }
+        bool isHeadless() const { return config.headless; }
+        bool isRenderingEnabled() const { return config.render && renderer; }
+        SpriteBatch& getSpriteBatch() { return spriteBatch; }
+        RenderQueue& getRenderQueue() { return renderQueue; }
+        StaticChunkCache& getStaticCache() { return staticCache; }
+        DebugDraw& getDebugDraw() { return debugDraw; }
+        ParticleSystem& getParticles() { return particles; }
+        float getRenderScale() const { return resolutionScaler.getScale(); } // Internal scale of the world pass
+        RenderStats& getRenderStats() { return renderStats; }
+        // Show additive per-draw coverage instead of the frame
+        void setOverdrawHeatmap(bool enabled);
+        bool isOverdrawHeatmapEnabled() const { return renderStats.isHeatmapEnabled(); }
         
         // Screen dimensions
         int getWidth() const { return width; }
@@ -34,7 +89,8 @@ public:
             
         void drawRect(float x, float y, float width, float height, int r, int g, int b, int a=255);
         //static void drawImage( std::string textureName, float x=0, float y=0, float width=100, float height=100, float angle=0  );
-        void drawImage( std::string textureName, float x=0, float y=0, float width=100, float height=100, float angle=0, bool centerOrigin = true);
+        void drawImage( const std::string& textureName, float x=0, float y=0, float width=100, float height=100, float angle=0, bool centerOrigin = true);
+        void drawImage( TextureHandle texture, float x=0, float y=0, float width=100, float height=100, float angle=0, bool centerOrigin = true);
     
         Object* getObject(int index){return objects[index].get();}
         Object* getLastObject(){return getObject(objects.size()-1);}
@@ -46,7 +102,7 @@ public:
         void updateView(Object* player);
         void setPlayer(Object* p) { player = p; }
         void setWorldSize(int w, int h) { view.worldWidth = w; view.worldHeight = h; }
-        void debugDrawObjects();
+        void debugDrawObjects(); // Physics shapes and query visuals (only while debug draw is enabled)
         int getWorldWidth() const { return view.worldWidth;}
         int getWorldHeight() const { return view.worldHeight;}
         void debugPlayerPosition(Object* player);
@@ -56,8 +112,23 @@ public:
         b2WorldId getWorldId() const { return worldId; }
         void loadLevel(const std::string& levelPath); // Load a new level
         void queueLevelLoad(const std::string& levelPath); // Queue a level load for next frame
+        /**
+         * Make the textures a level file uses resident before its objects are created
+         *
+         * References the level's set in ImageDevice and drops the previous level's,
+         * so textures only the old level used become candidates for eviction.
+         */
+        void requireLevelTextures(const std::string& levelPath);
+        void prefetchLevelTextures(const std::string& levelPath); // Start decoding them in the background
+        void addParallaxLayer(const ParallaxLayer& layer); // Kept ordered far to near
+        void clearParallaxLayers() { parallaxLayers.clear(); }
+        void submitParallaxLayers(); // Queue visible parallax tiles, skipping hidden layers
+        TileMap* addTileMap(std::unique_ptr<TileMap> map); // Level tile layers (collision already built)
+        void clearTileMaps() { tileMaps.clear(); }
+        bool overlapsSolidTile(float x, float y, float w, float h) const; // Any tile layer, SDL coordinates
         void renderHealthUI(); // Render health hearts on screen
         void renderGameOver(); // Render game over screen
+        void fillScreenRect(RenderLayer layer, uint16_t depth, const SDL_Rect& rect, SDL_Color color); // Queued screen-space fill
         bool isGameOver() const; // Check if game is over
         void resetGame(); // Reset game state
         
@@ -91,13 +162,39 @@ public:
   
 private:
     Object* player = nullptr;
+    ParticleSystem particles;  // declared before objects: emitter components stop theirs on destruction
     std::vector<std::unique_ptr<Object>> objects;
-    SDL_Window* window;
-    SDL_Renderer* renderer;
+    EngineConfig config;
+    SDL_Window* window = nullptr;
+    SDL_Renderer* renderer = nullptr;
+    SDL_Surface* headlessSurface = nullptr; // software render target in headless mode
+    SpriteBatch spriteBatch;
+    RenderQueue renderQueue;        // filled by gameplay code
+    RenderQueue frameQueue;         // snapshot being drawn
+    View frameView;                 // camera of the snapshot
+    bool frameFrozen = false;       // snapshot is an overlay on the freeze texture
+    RenderThread renderThread;
+    FramePacer framePacer;
+    StaticChunkCache staticCache;
+    DebugDraw debugDraw;
+    ResolutionScaler resolutionScaler; // world pass target, touched only where the renderer lives
+    RenderStats renderStats;           // counted where the frame is drawn
+
+    // Freeze-frame (see freezeFrame())
+    bool frozen = false;
+    bool frozenDirty = false;
+    uint64_t frozenSignature = 0;      // queue drawn last while frozen
+    SDL_Texture* freezeTexture = nullptr;
+    int freezeWidth = 0;
+    int freezeHeight = 0;
+    std::vector<ParallaxLayer> parallaxLayers; // sorted by factor, farthest first
+    std::vector<std::unique_ptr<TileMap>> tileMaps;
+    TextureHandle heartTexture = INVALID_TEXTURE; // health HUD icon
     View view;
     int width;
     int height;
-    float dt;
+    float dt = 1.0f / 60.0f;
+    double animationTime = 0.0;
 
     // Ground level (Y coordinate of the top of the ground)
     float groundY{600}; // Default bottom of window
@@ -116,6 +213,10 @@ private:
     // Level loading queue (to avoid crashes when loading during update)
     std::string queuedLevelPath; // Level path to load on next frame
     bool hasQueuedLevel = false;
+
+    // Textures referenced for the current level (see requireLevelTextures())
+    std::vector<TextureHandle> levelTextures;
+    std::string residentLevel;
     
     // Raycast visualization
     struct RaycastVisual {
@@ -134,10 +235,11 @@ private:
     std::vector<AABBQueryVisual> aabbQueryVisuals;
     
     // Internal methods
-    void processInput();
     //void updateView();
     void updateObjects();
-    void render();
+    void drawFrame(); // Draw the snapshot (render thread)
+    void captureFreezeFrame(); // Redraw the last snapshot into freezeTexture (render thread)
+    std::vector<std::string> levelTextureNames(const std::string& levelPath) const;
     
     // Helper for coordinate conversion
     float sdlToBox2DY(float sdlY) const { return view.worldHeight - sdlY; }
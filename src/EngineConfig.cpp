@@ -0,0 +1,115 @@
+#include "EngineConfig.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// "1", "true", "yes" and "on" switch a flag on
+static bool envFlag(const char* name) {
+    const char* value = std::getenv(name);
+    if (!value) return false;
+    return std::strcmp(value, "1") == 0 || std::strcmp(value, "true") == 0 ||
+           std::strcmp(value, "yes") == 0 || std::strcmp(value, "on") == 0;
+}
+
+EngineConfig EngineConfig::fromArgs(int argc, char* argv[]) {
+    EngineConfig config;
+
+    // Environment first, so command line flags can add to it
+    config.headless = envFlag("GAME_HEADLESS");
+    config.render = !envFlag("GAME_NO_RENDER");
+    config.renderThread = envFlag("GAME_RENDER_THREAD");
+    config.renderStats = envFlag("GAME_RENDER_STATS");
+    config.runInBackground = envFlag("GAME_RUN_IN_BACKGROUND");
+    if (const char* frames = std::getenv("GAME_FRAMES")) {
+        config.frames = std::atoi(frames);
+    }
+    if (const char* fps = std::getenv("GAME_FPS")) {
+        config.targetFps = std::atof(fps);
+    }
+    if (const char* particles = std::getenv("GAME_PARTICLES")) {
+        config.particleBudget = std::atoi(particles);
+    }
+    if (const char* threads = std::getenv("GAME_PARTICLE_THREADS")) {
+        config.particleThreads = std::atoi(threads);
+    }
+    if (const char* scale = std::getenv("GAME_MIN_RENDER_SCALE")) {
+        config.minRenderScale = float(std::atof(scale));
+    }
+    if (const char* scale = std::getenv("GAME_MAX_RENDER_SCALE")) {
+        config.maxRenderScale = float(std::atof(scale));
+    }
+    if (const char* budget = std::getenv("GAME_RENDER_BUDGET")) {
+        config.renderBudgetMs = std::atof(budget);
+    }
+    if (const char* budget = std::getenv("GAME_TEXTURE_BUDGET")) {
+        config.textureBudgetMB = std::atoi(budget);
+    }
+    bool pacingSet = parsePacing(std::getenv("GAME_PACING"), config.pacing);
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            config.headless = true;
+        } else if (std::strcmp(argv[i], "--no-render") == 0) {
+            config.render = false;
+        } else if (std::strcmp(argv[i], "--render-thread") == 0) {
+            config.renderThread = true;
+        } else if (std::strcmp(argv[i], "--render-stats") == 0) {
+            config.renderStats = true;
+        } else if (std::strcmp(argv[i], "--run-in-background") == 0) {
+            config.runInBackground = true;
+        } else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            config.frames = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            config.targetFps = std::atof(argv[++i]);
+            // Asking for a rate implies fixed pacing unless a mode is given too
+            if (!pacingSet) config.pacing = PacingMode::Fixed;
+        } else if (std::strcmp(argv[i], "--pacing") == 0 && i + 1 < argc) {
+            if (parsePacing(argv[++i], config.pacing)) {
+                pacingSet = true;
+            } else {
+                std::cerr << "EngineConfig: Unknown pacing mode " << argv[i] << std::endl;
+            }
+        } else if (std::strcmp(argv[i], "--particles") == 0 && i + 1 < argc) {
+            config.particleBudget = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--particle-threads") == 0 && i + 1 < argc) {
+            config.particleThreads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--min-render-scale") == 0 && i + 1 < argc) {
+            config.minRenderScale = float(std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--max-render-scale") == 0 && i + 1 < argc) {
+            config.maxRenderScale = float(std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--render-budget") == 0 && i + 1 < argc) {
+            config.renderBudgetMs = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--texture-budget") == 0 && i + 1 < argc) {
+            config.textureBudgetMB = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--uncapped") == 0) {
+            config.pacing = PacingMode::Uncapped;
+            pacingSet = true;
+        } else {
+            std::cerr << "EngineConfig: Ignoring unknown argument " << argv[i] << std::endl;
+        }
+    }
+
+    if (config.frames < 0) config.frames = 0;
+    if (config.targetFps <= 0.0) config.targetFps = 60.0;
+    if (config.particleBudget < 0) config.particleBudget = 0;
+    if (config.textureBudgetMB < 0) config.textureBudgetMB = 0;
+    if (config.maxRenderScale <= 0.0f || config.maxRenderScale > 1.0f) config.maxRenderScale = 1.0f;
+    if (config.minRenderScale <= 0.0f || config.minRenderScale > config.maxRenderScale) {
+        config.minRenderScale = config.maxRenderScale;
+    }
+    if (config.renderBudgetMs <= 0.0) config.renderBudgetMs = 0.8 * 1000.0 / config.targetFps;
+
+    // Headless runs are benchmarks unless told otherwise
+    if (config.headless && !pacingSet) {
+        config.pacing = PacingMode::Uncapped;
+    }
+    return config;
+}
+
+bool EngineConfig::parsePacing(const char* value, PacingMode& mode) {
+    if (!value) return false;
+    if (std::strcmp(value, "fixed") == 0) { mode = PacingMode::Fixed; return true; }
+    if (std::strcmp(value, "vsync") == 0) { mode = PacingMode::VSync; return true; }
+    if (std::strcmp(value, "uncapped") == 0) { mode = PacingMode::Uncapped; return true; }
+    return false;
+}
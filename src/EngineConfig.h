@@ -0,0 +1,48 @@
+#pragma once
+#include "FramePacer.h"
+
+/**
+ * EngineConfig - Start-up options for the Engine
+ *
+ * Read from the command line and environment:
+ *   --headless    or GAME_HEADLESS=1   no window; offscreen/dummy video driver and a
+ *                                      software renderer drawing into an SDL_Surface
+ *   --no-render   or GAME_NO_RENDER=1  skip all per-frame rendering (simulation only)
+ *   --frames N    or GAME_FRAMES=N     quit after N frames and print timing
+ *   --render-thread or GAME_RENDER_THREAD=1  draw on a dedicated render thread
+ *   --fps N       or GAME_FPS=N        target rate for fixed pacing
+ *   --pacing MODE or GAME_PACING=MODE  fixed, vsync or uncapped (headless defaults to uncapped)
+ *   --uncapped                         same as --pacing uncapped
+ *   --particles N or GAME_PARTICLES=N  global particle budget
+ *   --particle-threads N or GAME_PARTICLE_THREADS=N  worker threads for particle updates
+ *                                      (default: one less than the cores, at most 3)
+ *   --min-render-scale S or GAME_MIN_RENDER_SCALE=S  lowest internal resolution of the world pass
+ *   --max-render-scale S or GAME_MAX_RENDER_SCALE=S  highest (1 = native; equal bounds fix the scale)
+ *   --render-budget MS or GAME_RENDER_BUDGET=MS      draw time the scaler aims for
+ *                                      (default: 80% of the target frame time)
+ *   --render-stats or GAME_RENDER_STATS=1  count draws per frame (F3 prints them, F2 shows overdraw)
+ *   --run-in-background or GAME_RUN_IN_BACKGROUND=1  keep simulating while the window is unfocused
+ *   --texture-budget MB or GAME_TEXTURE_BUDGET=MB  texture memory kept resident across levels
+ *                                      (0 = unlimited; textures in use are never evicted)
+ */
+struct EngineConfig {
+    bool headless = false;
+    bool render = true;
+    bool renderThread = false;
+    int frames = 0;       // 0 = run until quit
+    PacingMode pacing = PacingMode::VSync;
+    double targetFps = 60.0;
+    int width = 800;
+    int height = 600;
+    int particleBudget = 131072;
+    int particleThreads = -1; // -1 = pick from the core count
+    float minRenderScale = 0.5f;
+    float maxRenderScale = 1.0f;
+    double renderBudgetMs = 0.0; // 0 = derive from targetFps
+    bool renderStats = false;
+    bool runInBackground = false;
+    int textureBudgetMB = 256;
+
+    static EngineConfig fromArgs(int argc, char* argv[]);
+    static bool parsePacing(const char* value, PacingMode& mode);
+};
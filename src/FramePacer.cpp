@@ -0,0 +1,129 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <iostream>
+
+// Below this much remaining time we spin instead of sleeping; SDL_Delay can oversleep by a scheduler tick
+static const double SPIN_THRESHOLD_SECONDS = 0.002;
+
+// Weight of the newest frame in the smoothed dt
+static const float SMOOTHING = 0.1f;
+
+FramePacer::FramePacer() {
+    frequency = SDL_GetPerformanceFrequency();
+    history.assign(STATS_WINDOW, 0);
+    setTargetRate(targetRate);
+}
+
+void FramePacer::setMode(PacingMode mode) {
+    this->mode = mode;
+    started = false; // restart the deadline schedule
+    std::cout << "FramePacer: " << modeName(mode);
+    if (mode == PacingMode::Fixed) std::cout << " at " << targetRate << " Hz";
+    std::cout << std::endl;
+}
+
+void FramePacer::setTargetRate(double hz) {
+    if (hz <= 0.0) hz = 60.0;
+    targetRate = hz;
+    period = Uint64(double(frequency) / hz);
+    started = false;
+}
+
+void FramePacer::beginFrame() {
+    Uint64 now = SDL_GetPerformanceCounter();
+
+    if (!started) {
+        // First frame: assume one period passed
+        started = true;
+        frameStart = now;
+        nextDeadline = now + period;
+        deltaTime = std::min(float(1.0 / targetRate), maxDeltaTime);
+        smoothedDeltaTime = deltaTime;
+        return;
+    }
+
+    Uint64 elapsed = now - frameStart;
+    frameStart = now;
+
+    deltaTime = std::min(float(double(elapsed) / double(frequency)), maxDeltaTime);
+    smoothedDeltaTime += (deltaTime - smoothedDeltaTime) * SMOOTHING;
+    ++frameCount;
+
+    history[historyNext] = elapsed;
+    historyNext = (historyNext + 1) % STATS_WINDOW;
+    historyCount = std::min(historyCount + 1, STATS_WINDOW);
+}
+
+void FramePacer::endFrame(bool idle) {
+    if (!started) return;
+    if (idle && mode == PacingMode::VSync) {
+        waitUntil(frameStart + period, false);
+        return;
+    }
+    if (mode != PacingMode::Fixed) return;
+
+    waitUntil(nextDeadline, !idle);
+
+    // Next deadline one period later; after a long stall restart from now instead of racing to catch up
+    Uint64 now = SDL_GetPerformanceCounter();
+    nextDeadline += period;
+    if (now > nextDeadline) {
+        nextDeadline = now + period;
+    }
+}
+
+void FramePacer::waitUntil(Uint64 deadline, bool spin) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (now >= deadline) return;
+
+    // Idle frames sleep the whole wait, rounded up, and never spin
+    if (!spin) {
+        Uint32 sleepMs = Uint32(((deadline - now) * 1000 + frequency - 1) / frequency);
+        SDL_Delay(sleepMs);
+        return;
+    }
+
+    // Sleep through most of the wait...
+    Uint64 spinTicks = Uint64(SPIN_THRESHOLD_SECONDS * double(frequency));
+    if (now + spinTicks < deadline) {
+        Uint64 sleepTicks = deadline - now - spinTicks;
+        Uint32 sleepMs = Uint32(sleepTicks * 1000 / frequency);
+        if (sleepMs > 0) SDL_Delay(sleepMs);
+    }
+
+    // ...then spin for the precise end
+    while (SDL_GetPerformanceCounter() < deadline) {
+    }
+}
+
+FrameStats FramePacer::getStats() const {
+    FrameStats stats;
+    if (historyCount == 0) return stats;
+
+    double toMs = 1000.0 / double(frequency);
+    int last = (historyNext + STATS_WINDOW - 1) % STATS_WINDOW;
+    stats.lastMs = history[last] * toMs;
+
+    Uint64 total = 0;
+    Uint64 minTicks = history[last];
+    Uint64 maxTicks = history[last];
+    for (int i = 0; i < historyCount; ++i) {
+        total += history[i];
+        minTicks = std::min(minTicks, history[i]);
+        maxTicks = std::max(maxTicks, history[i]);
+    }
+    stats.averageMs = double(total) / historyCount * toMs;
+    stats.minMs = minTicks * toMs;
+    stats.maxMs = maxTicks * toMs;
+    stats.fps = stats.averageMs > 0.0 ? 1000.0 / stats.averageMs : 0.0;
+    return stats;
+}
+
+const char* FramePacer::modeName(PacingMode mode) {
+    switch (mode) {
+        case PacingMode::Fixed: return "fixed";
+        case PacingMode::VSync: return "vsync";
+        case PacingMode::Uncapped: return "uncapped";
+    }
+    return "unknown";
+}
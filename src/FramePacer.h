@@ -0,0 +1,84 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+
+enum class PacingMode {
+    Fixed,    // wait for a target rate (sleep, then spin for the last bit)
+    VSync,    // the renderer's vsync'd present does the waiting
+    Uncapped  // no waiting at all (benchmarks)
+};
+
+/**
+ * Frame time statistics over the last FramePacer::STATS_WINDOW frames, in milliseconds
+ */
+struct FrameStats {
+    double lastMs = 0.0;
+    double averageMs = 0.0;
+    double minMs = 0.0;
+    double maxMs = 0.0;
+    double fps = 0.0;
+};
+
+/**
+ * FramePacer - High-resolution frame timing built on SDL_GetPerformanceCounter
+ *
+ * Call beginFrame() at the top of the loop and endFrame() at the bottom.
+ * beginFrame() measures the time since the previous frame; endFrame() waits
+ * for the next frame deadline in Fixed mode. Idle frames (nothing presented)
+ * sleep the period out without spinning, in VSync mode too since no present
+ * was there to block. Deadlines advance by exactly one
+ * period each frame so rounding errors do not accumulate into drift.
+ */
+class FramePacer {
+public:
+    static constexpr int STATS_WINDOW = 120;
+
+    FramePacer();
+
+    void setMode(PacingMode mode);
+    PacingMode getMode() const { return mode; }
+
+    void setTargetRate(double hz);
+    double getTargetRate() const { return targetRate; }
+
+    // Largest dt handed out (long stalls, breakpoints, window drags)
+    void setMaxDeltaTime(float seconds) { maxDeltaTime = seconds; }
+
+    void beginFrame();
+    void endFrame(bool idle = false);
+
+    // After blocking outside the loop (idle waits): the next frame starts fresh instead of
+    // reporting the whole wait as its dt
+    void resume() { started = false; }
+
+    // Seconds since the previous frame (clamped)
+    float getDeltaTime() const { return deltaTime; }
+    // Exponentially smoothed dt, steadier for animation and movement
+    float getSmoothedDeltaTime() const { return smoothedDeltaTime; }
+
+    FrameStats getStats() const;
+    long long getFrameCount() const { return frameCount; }
+
+    static const char* modeName(PacingMode mode);
+
+private:
+    void waitUntil(Uint64 deadline, bool spin = true);
+
+    PacingMode mode = PacingMode::Fixed;
+    double targetRate = 60.0;
+    Uint64 frequency = 1;
+    Uint64 period = 0;          // counter ticks per frame at the target rate
+    Uint64 frameStart = 0;
+    Uint64 nextDeadline = 0;
+    bool started = false;
+
+    float maxDeltaTime = 0.1f;
+    float deltaTime = 1.0f / 60.0f;
+    float smoothedDeltaTime = 1.0f / 60.0f;
+    long long frameCount = 0;
+
+    // Ring buffer of recent frame times (counter ticks)
+    std::vector<Uint64> history;
+    int historyNext = 0;
+    int historyCount = 0;
+};
@@ -0,0 +1,108 @@
+#include "GlyphAtlas.h"
+#include "Engine.h"
+#include <algorithm>
+#include <iostream>
+
+// Atlas width; height grows to fit the glyphs
+static const int ATLAS_WIDTH = 512;
+// Empty pixels around each glyph so linear filtering never picks up a neighbour
+static const int GLYPH_PADDING = 1;
+
+GlyphAtlas::~GlyphAtlas() {
+    if (texture) SDL_DestroyTexture(texture);
+    if (font) TTF_CloseFont(font);
+}
+
+bool GlyphAtlas::load(const std::string& path, int pointSize) {
+    font = TTF_OpenFont(path.c_str(), pointSize);
+    if (!font) {
+        std::cerr << "GlyphAtlas: Failed to open font '" << path << "': " << TTF_GetError() << std::endl;
+        return false;
+    }
+    lineHeight = TTF_FontLineSkip(font);
+    kerning = TTF_GetFontKerning(font) != 0;
+
+    // Render every glyph in white; colour is applied per vertex when drawing
+    const SDL_Color white = {255, 255, 255, 255};
+    std::vector<SDL_Surface*> surfaces(LAST_CHAR - FIRST_CHAR + 1, nullptr);
+    glyphs.assign(surfaces.size(), Glyph{});
+
+    // Shelf packing: fill rows left to right, start a new row when one is full
+    int penX = GLYPH_PADDING;
+    int penY = GLYPH_PADDING;
+    int rowHeight = 0;
+    for (Uint32 ch = FIRST_CHAR; ch <= LAST_CHAR; ++ch) {
+        size_t index = ch - FIRST_CHAR;
+        if (!TTF_GlyphIsProvided32(font, ch)) continue;
+
+        int minX, maxX, minY, maxY, advance;
+        if (TTF_GlyphMetrics32(font, ch, &minX, &maxX, &minY, &maxY, &advance) != 0) continue;
+
+        Glyph& glyph = glyphs[index];
+        glyph.advance = advance;
+        glyph.offsetX = std::min(minX, 0);
+        glyph.valid = true;
+
+        // Space and friends have no pixels, only an advance
+        if (ch == ' ') continue;
+
+        SDL_Surface* surface = TTF_RenderGlyph32_Blended(font, ch, white);
+        if (!surface) continue;
+        surfaces[index] = surface;
+
+        if (penX + surface->w + GLYPH_PADDING > ATLAS_WIDTH) {
+            penX = GLYPH_PADDING;
+            penY += rowHeight + GLYPH_PADDING;
+            rowHeight = 0;
+        }
+        glyph.src = SDL_Rect{penX, penY, surface->w, surface->h};
+        penX += surface->w + GLYPH_PADDING;
+        rowHeight = std::max(rowHeight, surface->h);
+    }
+
+    int atlasHeight = 1;
+    while (atlasHeight < penY + rowHeight + GLYPH_PADDING) atlasHeight *= 2;
+
+    SDL_Surface* atlas = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_WIDTH, atlasHeight, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!atlas) {
+        std::cerr << "GlyphAtlas: Failed to create atlas surface: " << SDL_GetError() << std::endl;
+        for (SDL_Surface* surface : surfaces) if (surface) SDL_FreeSurface(surface);
+        return false;
+    }
+    SDL_FillRect(atlas, nullptr, SDL_MapRGBA(atlas->format, 255, 255, 255, 0));
+
+    for (size_t i = 0; i < surfaces.size(); ++i) {
+        if (!surfaces[i]) continue;
+        // Copy alpha as-is instead of blending onto the transparent atlas
+        SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+        SDL_BlitSurface(surfaces[i], nullptr, atlas, &glyphs[i].src);
+        SDL_FreeSurface(surfaces[i]);
+    }
+
+    Engine::E->runOnRenderThread([&]() {
+        texture = SDL_CreateTextureFromSurface(Engine::E->getRenderer(), atlas);
+        if (texture) SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    });
+    SDL_FreeSurface(atlas);
+
+    if (!texture) {
+        std::cerr << "GlyphAtlas: Failed to create atlas texture: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    std::cout << "GlyphAtlas: Baked '" << path << "' at " << pointSize << "pt into "
+              << ATLAS_WIDTH << "x" << atlasHeight << std::endl;
+    return true;
+}
+
+const Glyph& GlyphAtlas::getGlyph(Uint32 ch) const {
+    if (ch >= FIRST_CHAR && ch <= LAST_CHAR && glyphs[ch - FIRST_CHAR].valid) {
+        return glyphs[ch - FIRST_CHAR];
+    }
+    return glyphs['?' - FIRST_CHAR];
+}
+
+int GlyphAtlas::getKerning(Uint32 previous, Uint32 ch) const {
+    if (!kerning || !font) return 0;
+    return TTF_GetFontKerningSizeGlyphs32(font, previous, ch);
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <string>
+#include <vector>
+
+/**
+ * A baked glyph: where it sits in the atlas and how it advances the pen
+ */
+struct Glyph {
+    SDL_Rect src{0, 0, 0, 0}; // rectangle in the atlas texture
+    int offsetX = 0;          // cell position relative to the pen
+    int advance = 0;
+    bool valid = false;
+};
+
+/**
+ * GlyphAtlas - One font at one point size, baked into a single texture
+ *
+ * Printable ASCII glyphs are rendered once in white with TTF_RenderGlyph32_Blended
+ * and shelf-packed into an atlas. Text is then drawn as quads sampling that one
+ * texture, tinted with vertex colour, so any string in any colour costs no
+ * surface or texture work and batches into a single draw call.
+ */
+class GlyphAtlas {
+public:
+    static constexpr Uint32 FIRST_CHAR = 32;
+    static constexpr Uint32 LAST_CHAR = 126;
+
+    GlyphAtlas() = default;
+    ~GlyphAtlas();
+
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+    /**
+     * Open the font and bake the atlas
+     * @param path TTF file
+     * @param pointSize Size in points
+     * @return true on success
+     */
+    bool load(const std::string& path, int pointSize);
+
+    // Glyph for a character; characters outside the atlas map to '?'
+    const Glyph& getGlyph(Uint32 ch) const;
+
+    // Extra horizontal spacing between two characters
+    int getKerning(Uint32 previous, Uint32 ch) const;
+
+    int getLineHeight() const { return lineHeight; }
+    SDL_Texture* getTexture() const { return texture; }
+
+private:
+    TTF_Font* font = nullptr;
+    SDL_Texture* texture = nullptr;
+    std::vector<Glyph> glyphs; // indexed by ch - FIRST_CHAR
+    int lineHeight = 0;
+    bool kerning = false;
+};
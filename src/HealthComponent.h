@@ -12,6 +12,7 @@ public:
     int getMaxHealth() const { return maxHealth; }
     void takeDamage(int damage = 1);
     bool isDead() const { return currentHealth <= 0; }
+    bool isInvulnerable() const { return invulnerabilityTime > 0.0f; } // just took damage
     void reset() { 
         currentHealth = maxHealth; 
         invulnerabilityTime = 0.0f;
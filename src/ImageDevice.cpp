@@ -1,17 +1,50 @@
 #include "ImageDevice.h"
+#include "AsyncImageLoader.h"
 #include "Engine.h"
+#include "TextureAtlas.h"
 #include "tinyxml2.h"
 #include <SDL_image.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
+#include <unordered_set>
 
 using namespace tinyxml2;
 
 
 // Static member definitions
-std::unordered_map<std::string, SDL_Texture*> ImageDevice::textures;
+std::vector<ImageDevice::TextureEntry> ImageDevice::entries(1);
+std::unordered_map<std::string, TextureHandle> ImageDevice::handles;
+SDL_Texture* ImageDevice::whiteTexture = nullptr;
+SDL_Texture* ImageDevice::fallbackTexture = nullptr;
+std::unique_ptr<AsyncImageLoader> ImageDevice::asyncLoader;
+Uint32 ImageDevice::uploadFormat = SDL_PIXELFORMAT_UNKNOWN;
+std::vector<DecodedImage> ImageDevice::atlasQueue;
+std::unordered_map<SDL_Texture*, ImageDevice::Resident> ImageDevice::residents;
+size_t ImageDevice::memoryUsage = 0;
+size_t ImageDevice::memoryBudget = 0;
+uint64_t ImageDevice::useClock = 0;
+int ImageDevice::atlasCount = 0;
 
 
 bool ImageDevice::loadFromXML(const std::string& xmlPath)
+{
+    // Same path as the background load (parallel decoding, atlas packing), just waited for
+    if (!loadFromXMLAsync(xmlPath)) return false;
+    finishAsyncLoads();
+    return true;
+}
+
+bool ImageDevice::loadFromXMLAsync(const std::string& xmlPath)
+{
+    std::vector<std::string> textures;
+    if (!registerFromXML(xmlPath, &textures)) return false;
+    prefetch(textures);
+    return true;
+}
+
+bool ImageDevice::registerFromXML(const std::string& xmlPath, std::vector<std::string>* textures)
 {
     XMLDocument doc;
     if (doc.LoadFile(xmlPath.c_str()) != XML_SUCCESS) {
@@ -25,23 +58,199 @@ bool ImageDevice::loadFromXML(const std::string& xmlPath)
         return false;
     }
 
+    size_t registered = 0;
     for (XMLElement* tex = root->FirstChildElement("Texture"); tex; tex = tex->NextSiblingElement("Texture")) {
         const char* name = tex->Attribute("name");
         const char* file = tex->Attribute("file");
 
         if (name && file) {
-            if (!ImageDevice::exists(name)) {
-                ImageDevice::load(name, file);
-                std::cout << "Loaded texture: " << name << " from " << file << std::endl;
-            }
+            TextureEntry& entry = entries[getHandle(name)];
+            entry.file = file;
+            entry.atlasAllowed = tex->BoolAttribute("atlas", true);
+            if (textures) textures->push_back(name);
+            ++registered;
         } else {
             std::cerr << "Texture entry missing name or file attribute in " << xmlPath << std::endl;
         }
     }
 
+    // Regions are cut whenever their parents are resident, in the order they are declared
+    for (XMLElement* reg = root->FirstChildElement("Region"); reg; reg = reg->NextSiblingElement("Region")) {
+        const char* name = reg->Attribute("name");
+        const char* parent = reg->Attribute("texture");
+        const char* rect = reg->Attribute("rect");
+        SDL_Rect area{0, 0, 0, 0};
+        if (!name || !parent || !rect || std::sscanf(rect, "%d,%d,%d,%d", &area.x, &area.y, &area.w, &area.h) != 4) {
+            std::cerr << "Region entry needs name, texture and rect=\"x,y,w,h\" in " << xmlPath << std::endl;
+            continue;
+        }
+        if (defineRegion(name, parent, area)) ++registered;
+    }
+
+    std::cout << "ImageDevice: Registered " << registered << " textures and regions from '" << xmlPath << "'" << std::endl;
     return true;
 }
 
+void ImageDevice::startBatch(std::vector<std::pair<std::string, std::string>> files) {
+    finishAsyncLoads();
+
+    if (!asyncLoader) {
+        asyncLoader.reset(new AsyncImageLoader());
+        // The loader thread decodes a slice itself
+        int threads = std::clamp(int(std::thread::hardware_concurrency()) - 1, 1, 4);
+        asyncLoader->setWorkerCount(unsigned(threads - 1));
+    }
+
+    // Decode straight into a format the renderer takes so uploads need no conversion.
+    // Like atlas pages it must keep alpha, or transparent images would turn opaque
+    uploadFormat = SDL_PIXELFORMAT_ARGB8888;
+    Engine::E->runOnRenderThread([&]() {
+        SDL_RendererInfo info;
+        if (SDL_GetRendererInfo(Engine::E->getRenderer(), &info) != 0) return;
+        for (Uint32 i = 0; i < info.num_texture_formats; ++i) {
+            Uint32 format = info.texture_formats[i];
+            if (SDL_ISPIXELFORMAT_ALPHA(format) && SDL_BYTESPERPIXEL(format) == 4) {
+                uploadFormat = format;
+                break;
+            }
+        }
+    });
+
+    std::cout << "ImageDevice: Loading " << files.size() << " textures in the background" << std::endl;
+    asyncLoader->start(std::move(files), uploadFormat);
+}
+
+bool ImageDevice::updateAsyncLoads(double budgetMs) {
+    if (!isLoading()) return false;
+
+    auto start = std::chrono::steady_clock::now();
+    DecodedImage image;
+    while (asyncLoader->poll(image)) {
+        const TextureEntry& entry = entries[getHandle(image.name)];
+        if (image.surface && entry.atlasAllowed &&
+            image.surface->w <= ATLAS_MAX_ENTRY && image.surface->h <= ATLAS_MAX_ENTRY) {
+            // Packed with the rest of the batch once everything is decoded
+            atlasQueue.push_back(std::move(image));
+            image = DecodedImage();
+        } else if (image.surface) {
+            if (upload(image.name, image.surface, image.hasMask ? &image.mask : nullptr)) {
+                std::cout << "ImageDevice: Loaded texture '" << image.name << "' from '" << image.file << "'" << std::endl;
+            }
+            SDL_FreeSurface(image.surface);
+            image.surface = nullptr;
+        }
+
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (elapsed >= budgetMs) break;
+    }
+
+    // One larger step at the end of the batch
+    if (!asyncLoader->isBusy() && !atlasQueue.empty()) buildAtlases();
+    return isLoading();
+}
+
+void ImageDevice::buildAtlases() {
+    int pageSize = ATLAS_PAGE_SIZE;
+    Engine::E->runOnRenderThread([&]() {
+        SDL_RendererInfo info;
+        if (SDL_GetRendererInfo(Engine::E->getRenderer(), &info) == 0) {
+            if (info.max_texture_width > 0) pageSize = std::min(pageSize, info.max_texture_width);
+            if (info.max_texture_height > 0) pageSize = std::min(pageSize, info.max_texture_height);
+        }
+    });
+
+    TextureAtlas atlas(pageSize, ATLAS_PADDING, ATLAS_EXTRUDE);
+    std::unordered_map<std::string, size_t> queued;
+    for (size_t i = 0; i < atlasQueue.size(); ++i) {
+        const DecodedImage& image = atlasQueue[i];
+        if (!atlas.accepts(image.surface->w, image.surface->h, ATLAS_MAX_ENTRY)) continue;
+        atlas.add(image.name, image.surface);
+        queued[image.name] = i;
+    }
+
+    // Pages need an alpha channel whatever the renderer prefers
+    Uint32 format = uploadFormat;
+    if (format == SDL_PIXELFORMAT_UNKNOWN || !SDL_ISPIXELFORMAT_ALPHA(format) || SDL_BYTESPERPIXEL(format) != 4) {
+        format = SDL_PIXELFORMAT_ARGB8888;
+    }
+
+    std::vector<SDL_Texture*> pageTextures;
+    if (!queued.empty() && atlas.pack(format)) {
+        for (SDL_Surface* page : atlas.getPages()) {
+            SDL_Texture* texture = nullptr;
+            Engine::E->runOnRenderThread([&]() {
+                texture = SDL_CreateTextureFromSurface(Engine::E->getRenderer(), page);
+            });
+            if (!texture) {
+                std::cerr << "ImageDevice: Failed to create atlas page: " << SDL_GetError() << std::endl;
+            }
+            pageTextures.push_back(texture);
+        }
+    }
+
+    std::vector<std::string> pageLabels;
+    for (size_t i = 0; i < pageTextures.size(); ++i) {
+        pageLabels.push_back("atlas" + std::to_string(atlasCount++));
+        if (!pageTextures[i]) continue;
+        addResident(pageTextures[i], pageLabels.back());
+        const SDL_Surface* page = atlas.getPages()[i];
+        std::cout << "ImageDevice: Atlas page " << pageLabels.back() << " is " << page->w << "x" << page->h << std::endl;
+    }
+
+    size_t packed = 0;
+    for (const TextureAtlas::Region& region : atlas.getRegions()) {
+        SDL_Texture* page = pageTextures.size() > region.page ? pageTextures[region.page] : nullptr;
+        if (!page) continue;
+
+        DecodedImage& image = atlasQueue[queued[region.name]];
+        TextureHandle handle = getHandle(region.name);
+        TextureEntry& entry = entries[handle];
+        entry.texture = page;
+        entry.area = region.rect;
+        entry.shared = true;
+        entry.reported = false;
+        entry.lastUsed = ++useClock;
+        entry.mask = image.hasMask ? std::move(image.mask) : AlphaMask();
+        entry.hasMask = image.hasMask;
+        SDL_FreeSurface(image.surface);
+        image.surface = nullptr;
+        refreshRegions(handle);
+        ++packed;
+        std::cout << "ImageDevice: Loaded texture '" << image.name << "' from '" << image.file << "' into "
+                  << pageLabels[region.page] << " at (" << region.rect.x << "," << region.rect.y << ")" << std::endl;
+    }
+    std::cout << "ImageDevice: Packed " << packed << " of " << atlasQueue.size() << " textures into "
+              << pageTextures.size() << " atlas pages" << std::endl;
+
+    // Whatever did not make it into a page stays a texture of its own
+    for (DecodedImage& image : atlasQueue) {
+        if (!image.surface) continue;
+        if (upload(image.name, image.surface, image.hasMask ? &image.mask : nullptr)) {
+            std::cout << "ImageDevice: Loaded texture '" << image.name << "' from '" << image.file << "'" << std::endl;
+        }
+        SDL_FreeSurface(image.surface);
+    }
+    atlasQueue.clear();
+}
+
+void ImageDevice::finishAsyncLoads() {
+    while (isLoading()) {
+        if (!updateAsyncLoads(1000.0)) break;
+        SDL_Delay(1);
+    }
+}
+
+bool ImageDevice::isLoading() {
+    return (asyncLoader && asyncLoader->isBusy()) || !atlasQueue.empty();
+}
+
+float ImageDevice::getLoadProgress() {
+    if (!asyncLoader || asyncLoader->getTotal() == 0) return 1.0f;
+    float progress = float(asyncLoader->getPolled()) / float(asyncLoader->getTotal());
+    // Not done until the atlases are built
+    return atlasQueue.empty() ? progress : std::min(progress, 0.99f);
+}
+
 bool ImageDevice::load(const std::string& name, const std::string& imagePath) {
     // Load the image surface
     SDL_Surface* surface = IMG_Load(imagePath.c_str());
@@ -50,78 +259,553 @@ bool ImageDevice::load(const std::string& name, const std::string& imagePath) {
         return false;
     }
     
-    // Create texture from surface
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(Engine::E->getRenderer(), surface);
+    AlphaMask mask;
+    bool hasMask = buildAlphaMask(surface, mask);
+    bool uploaded = upload(name, surface, hasMask ? &mask : nullptr);
     SDL_FreeSurface(surface);
+    if (!uploaded) return false;
+
+    // Remembered so the texture can be loaded again after an eviction
+    entries[getHandle(name)].file = imagePath;
+    std::cout << "ImageDevice: Loaded texture '" << name << "' from '" << imagePath << "'" << std::endl;
+    return true;
+}
+
+bool ImageDevice::upload(const std::string& name, SDL_Surface* surface, AlphaMask* mask) {
+    // Create texture from surface (uploads happen where the renderer lives)
+    SDL_Texture* texture = nullptr;
+    Engine::E->runOnRenderThread([&]() {
+        texture = SDL_CreateTextureFromSurface(Engine::E->getRenderer(), surface);
+    });
     if (!texture) {
-        std::cerr << "ImageDevice: Failed to create texture from '" << imagePath << "': " << SDL_GetError() << std::endl;
+        std::cerr << "ImageDevice: Failed to create texture '" << name << "': " << SDL_GetError() << std::endl;
         return false;
     }
-    
-    textures[name] = texture;
-    std::cout << "ImageDevice: Loaded texture '" << name << "' from '" << imagePath << std::endl;
-    
+
+    // Handles given out before the texture arrived start drawing it now
+    TextureHandle handle = getHandle(name);
+    if (entries[handle].texture && !entries[handle].shared) evict(entries[handle].texture);
+    addResident(texture, name);
+
+    TextureEntry& entry = entries[handle];
+    entry.texture = texture;
+    entry.area = SDL_Rect{0, 0, surface->w, surface->h};
+    entry.shared = false;
+    entry.reported = false;
+    entry.lastUsed = ++useClock;
+    if (mask) {
+        if (mask->bounds.w != mask->width || mask->bounds.h != mask->height) {
+            std::cout << "ImageDevice: '" << name << "' visible area " << mask->bounds.w << "x" << mask->bounds.h
+                      << " of " << mask->width << "x" << mask->height << std::endl;
+        }
+        entry.mask = std::move(*mask);
+        entry.hasMask = true;
+    } else {
+        entry.mask = AlphaMask();
+        entry.hasMask = false;
+    }
+    refreshRegions(handle);
     return true;
 }
 
 bool ImageDevice::load(const std::string& name, const std::string& imagePath, SDL_Rect srcRect) {
-    // Load the image surface
-    SDL_Surface* surface = IMG_Load(imagePath.c_str());
-    if (!surface) {
-        std::cerr << "ImageDevice: Failed to load image '" << imagePath << "': " << IMG_GetError() << std::endl;
-        return false;
-    }
+    // The sheet is decoded and uploaded once, under its path; every crop of it is a region
+    if (!exists(imagePath) && !load(imagePath, imagePath)) return false;
+    if (!defineRegion(name, imagePath, srcRect)) return false;
+
+    std::cout << "ImageDevice: Loaded texture '" << name << "' from '" << imagePath << "' region (" << srcRect.x << "," << srcRect.y << "," << srcRect.w << "," << srcRect.h << ")" << std::endl;
     
-    // Create texture from surface
-    // Extract just the rectangle and make a new texture
-    SDL_Surface* croppedSurface = SDL_CreateRGBSurfaceWithFormat(0, srcRect.w, srcRect.h, surface->format->BitsPerPixel, surface->format->format);
-    if (!croppedSurface) {
-        std::cerr << "ImageDevice: Failed to create cropped surface: " << SDL_GetError() << std::endl;
-        SDL_FreeSurface(surface);
+    return true;
+}
+
+bool ImageDevice::defineRegion(const std::string& name, const std::string& parent, SDL_Rect rect) {
+    if (name == parent) return false;
+    TextureHandle parentHandle = getHandle(parent);
+    TextureHandle handle = getHandle(name);
+    if (!isRegistered(parentHandle) || rootOf(parentHandle) == handle) {
+        std::cerr << "ImageDevice: Region '" << name << "' refers to unknown texture '" << parent << "'" << std::endl;
         return false;
     }
-    if (SDL_BlitSurface(surface, &srcRect, croppedSurface, nullptr) != 0) {
-        std::cerr << "ImageDevice: Failed to blit surface: " << SDL_GetError() << std::endl;
-        SDL_FreeSurface(surface);
-        SDL_FreeSurface(croppedSurface);
-        return false;
+
+    // A name that had an image of its own gives it up
+    if (entries[handle].texture && !entries[handle].shared) evict(entries[handle].texture);
+
+    TextureEntry& entry = entries[handle];
+    entry.file.clear();
+    entry.parent = parentHandle;
+    entry.regionRect = rect;
+    cutRegion(handle);
+    refreshRegions(handle);
+    return true;
+}
+
+void ImageDevice::cutRegion(TextureHandle handle) {
+    TextureEntry& entry = entries[handle];
+    const TextureEntry& source = entries[entry.parent];
+    entry.texture = nullptr;
+    entry.shared = false;
+    if (!source.texture) {
+        // Keeps the size it had, for whoever lays out frames before it is back
+        if (entry.area.w == 0) entry.area = SDL_Rect{0, 0, entry.regionRect.w, entry.regionRect.h};
+        entry.area.x = entry.area.y = 0;
+        return;
     }
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(Engine::E->getRenderer(), croppedSurface);
-    SDL_FreeSurface(surface);
-    SDL_FreeSurface(croppedSurface);
-    if (!texture) {
-        std::cerr << "ImageDevice: Failed to create texture from '" << imagePath << "': " << SDL_GetError() << std::endl;
+
+    // Clipped to the parent, in the parent's own coordinates
+    SDL_Rect bounds = {0, 0, source.area.w, source.area.h};
+    SDL_Rect clipped;
+    if (!SDL_IntersectRect(&entry.regionRect, &bounds, &clipped)) {
+        std::cerr << "ImageDevice: Region '" << entry.name << "' lies outside '" << source.name << "'" << std::endl;
+        entry.area = SDL_Rect{0, 0, 0, 0};
+        return;
+    }
+
+    AlphaMask mask;
+    bool hasMask = source.hasMask && source.mask.crop(clipped, mask);
+    entry.texture = source.texture;
+    entry.area = SDL_Rect{source.area.x + clipped.x, source.area.y + clipped.y, clipped.w, clipped.h};
+    entry.shared = true;
+    entry.reported = false;
+    entry.mask = std::move(mask);
+    entry.hasMask = hasMask;
+}
+
+void ImageDevice::refreshRegions(TextureHandle handle) {
+    for (TextureHandle h = 1; h < entries.size(); ++h) {
+        if (entries[h].parent != handle) continue;
+        cutRegion(h);
+        refreshRegions(h);
+    }
+}
+
+SDL_Texture* ImageDevice::get(const std::string& name) {
+    TextureHandle handle = getHandle(name);
+    TextureEntry& entry = entries[handle];
+    if (!entry.texture && !entry.reported && !ensureResident(handle)) {
+        std::cerr << "ImageDevice: Texture '" << name << "' not found!" << std::endl;
+        entries[handle].reported = true;
+    }
+    return entries[handle].texture;
+}
+
+TextureHandle ImageDevice::getHandle(const std::string& name) {
+    auto it = handles.find(name);
+    if (it != handles.end()) return it->second;
+
+    TextureHandle handle = TextureHandle(entries.size());
+    entries.emplace_back();
+    entries.back().name = name;
+    handles.emplace(name, handle);
+    return handle;
+}
+
+SDL_Texture* ImageDevice::missing(TextureHandle handle) {
+    if (handle != INVALID_TEXTURE && handle < entries.size() && !entries[handle].reported) {
+        // Registered but evicted (or never required): a hitch now beats a wrong picture
+        if (ensureResident(handle)) return entries[handle].texture;
+        std::cerr << "ImageDevice: Texture '" << entries[handle].name << "' not found, drawing the fallback" << std::endl;
+        entries[handle].reported = true;
+    }
+    return getFallbackTexture();
+}
+
+
+TextureHandle ImageDevice::rootOf(TextureHandle handle) {
+    // Bounded in case regions were declared in a loop
+    for (int depth = 0; depth < 16 && handle < entries.size() && entries[handle].parent != INVALID_TEXTURE; ++depth) {
+        handle = entries[handle].parent;
+    }
+    return handle;
+}
+
+bool ImageDevice::isRegistered(TextureHandle handle) {
+    if (handle == INVALID_TEXTURE || handle >= entries.size()) return false;
+    const TextureEntry& entry = entries[handle];
+    return entry.texture || !entry.file.empty() || entry.parent != INVALID_TEXTURE;
+}
+
+std::vector<std::pair<std::string, std::string>> ImageDevice::missingFiles(const std::vector<std::string>& names) {
+    std::vector<std::pair<std::string, std::string>> files;
+    std::unordered_set<TextureHandle> seen;
+    for (const std::string& name : names) {
+        auto it = handles.find(name);
+        if (it == handles.end()) continue;
+        TextureHandle root = rootOf(it->second);
+        const TextureEntry& entry = entries[root];
+        if (entry.texture || entry.file.empty() || !seen.insert(root).second) continue;
+        files.emplace_back(entry.name, entry.file);
+    }
+    return files;
+}
+
+std::vector<TextureHandle> ImageDevice::require(const std::vector<std::string>& names) {
+    std::vector<TextureHandle> required;
+    for (const std::string& name : names) {
+        TextureHandle handle = getHandle(name);
+        if (!isRegistered(handle)) {
+            std::cerr << "ImageDevice: Required texture '" << name << "' is not registered" << std::endl;
+            continue;
+        }
+        acquire(handle);
+        required.push_back(handle);
+    }
+
+    // A prefetch of the same set may already be on its way
+    finishAsyncLoads();
+    std::vector<std::pair<std::string, std::string>> files = missingFiles(names);
+    if (!files.empty()) {
+        startBatch(std::move(files));
+        finishAsyncLoads();
+    }
+    return required;
+}
+
+void ImageDevice::prefetch(const std::vector<std::string>& names) {
+    std::vector<std::pair<std::string, std::string>> files = missingFiles(names);
+    if (!files.empty()) startBatch(std::move(files));
+}
+
+void ImageDevice::acquire(TextureHandle handle) {
+    if (handle == INVALID_TEXTURE || handle >= entries.size()) return;
+    TextureEntry& root = entries[rootOf(handle)];
+    ++root.refs;
+    root.lastUsed = ++useClock;
+}
+
+void ImageDevice::release(TextureHandle handle) {
+    if (handle == INVALID_TEXTURE || handle >= entries.size()) return;
+    TextureEntry& root = entries[rootOf(handle)];
+    if (root.refs > 0) --root.refs;
+    root.lastUsed = ++useClock;
+}
+
+void ImageDevice::release(const std::vector<TextureHandle>& handles) {
+    for (TextureHandle handle : handles) release(handle);
+}
+
+int ImageDevice::getRefCount(TextureHandle handle) {
+    if (handle == INVALID_TEXTURE || handle >= entries.size()) return 0;
+    return entries[rootOf(handle)].refs;
+}
+
+bool ImageDevice::ensureResident(TextureHandle handle) {
+    if (handle == INVALID_TEXTURE || handle >= entries.size()) return false;
+    if (entries[handle].texture) return true;
+
+    // It may be in the batch still in flight
+    if (isLoading()) {
+        finishAsyncLoads();
+        if (entries[handle].texture) return true;
+    }
+
+    TextureHandle root = rootOf(handle);
+    if (entries[root].texture || entries[root].file.empty()) return false;
+    std::string name = entries[root].name;
+    std::string file = entries[root].file;
+    if (!load(name, file)) return false;
+    std::cout << "ImageDevice: Streamed in '" << name << "' on demand" << std::endl;
+    return entries[handle].texture != nullptr;
+}
+
+void ImageDevice::addResident(SDL_Texture* texture, const std::string& label) {
+    Uint32 format = 0;
+    int w = 0, h = 0;
+    SDL_QueryTexture(texture, &format, nullptr, &w, &h);
+    int bytesPerPixel = SDL_BYTESPERPIXEL(format) > 0 ? SDL_BYTESPERPIXEL(format) : 4;
+
+    Resident& resident = residents[texture];
+    resident.label = label;
+    resident.bytes = size_t(w) * size_t(h) * size_t(bytesPerPixel);
+    memoryUsage += resident.bytes;
+}
+
+void ImageDevice::evict(SDL_Texture* texture) {
+    auto it = residents.find(texture);
+    if (it != residents.end()) {
+        memoryUsage -= it->second.bytes;
+        residents.erase(it);
+    }
+
+    // The previous frame may still be drawing from it on the render thread
+    RenderQueue::forgetTexture(texture);
+    Engine::E->waitForFrame();
+    Engine::E->runOnRenderThread([&]() {
+        SDL_DestroyTexture(texture);
+    });
+
+    std::vector<TextureHandle> roots;
+    for (TextureHandle h = 1; h < entries.size(); ++h) {
+        TextureEntry& entry = entries[h];
+        if (entry.texture != texture || entry.parent != INVALID_TEXTURE) continue;
+        entry.texture = nullptr;
+        entry.shared = false;
+        entry.area = SDL_Rect{0, 0, entry.area.w, entry.area.h};
+        roots.push_back(h);
+    }
+    for (TextureHandle root : roots) refreshRegions(root);
+}
+
+void ImageDevice::trimToBudget() {
+    if (memoryBudget == 0 || memoryUsage <= memoryBudget) return;
+
+    struct Candidate {
+        SDL_Texture* texture;
+        uint64_t lastUsed;
+    };
+    std::unordered_map<SDL_Texture*, Candidate> candidates;
+    std::unordered_set<SDL_Texture*> pinned;
+    for (TextureHandle h = 1; h < entries.size(); ++h) {
+        const TextureEntry& entry = entries[h];
+        if (!entry.texture) continue;
+        // Drawing a region counts as using its page or sheet
+        Candidate& candidate = candidates.emplace(entry.texture, Candidate{entry.texture, 0}).first->second;
+        candidate.lastUsed = std::max(candidate.lastUsed, entry.lastUsed);
+        // Referenced, or nothing to load it from again (references and files live on the root)
+        if (entry.parent == INVALID_TEXTURE && (entry.refs > 0 || entry.file.empty())) pinned.insert(entry.texture);
+    }
+
+    std::vector<Candidate> order;
+    for (const auto& [texture, candidate] : candidates) {
+        if (!pinned.count(texture) && residents.count(texture)) order.push_back(candidate);
+    }
+    std::sort(order.begin(), order.end(), [](const Candidate& a, const Candidate& b) {
+        return a.lastUsed < b.lastUsed;
+    });
+
+    size_t before = memoryUsage;
+    int evicted = 0;
+    for (const Candidate& candidate : order) {
+        if (memoryUsage <= memoryBudget) break;
+        std::cout << "ImageDevice: Evicting '" << residents[candidate.texture].label << "' ("
+                  << residents[candidate.texture].bytes / 1024 << " KB)" << std::endl;
+        evict(candidate.texture);
+        ++evicted;
+    }
+
+    std::cout << "ImageDevice: Evicted " << evicted << " textures, " << (before - memoryUsage) / 1024
+              << " KB freed; " << memoryUsage / 1024 << " KB of " << memoryBudget / 1024 << " KB in use" << std::endl;
+    if (memoryUsage > memoryBudget) {
+        std::cerr << "ImageDevice: Referenced textures alone exceed the memory budget" << std::endl;
+    }
+}
+
+size_t ImageDevice::getMemoryUsage(TextureHandle handle) {
+    if (handle >= entries.size() || !entries[handle].texture) return 0;
+    const TextureEntry& entry = entries[handle];
+    if (entry.shared) return size_t(entry.area.w) * size_t(entry.area.h) * 4;
+    auto it = residents.find(entry.texture);
+    return it != residents.end() ? it->second.bytes : 0;
+}
+
+void ImageDevice::printMemory(std::ostream& out) {
+    struct Row {
+        const Resident* resident = nullptr;
+        int images = 0;
+        int refs = 0;
+    };
+    std::unordered_map<SDL_Texture*, Row> rows;
+    for (const auto& [texture, resident] : residents) rows[texture].resident = &resident;
+    for (TextureHandle h = 1; h < entries.size(); ++h) {
+        const TextureEntry& entry = entries[h];
+        auto it = entry.parent == INVALID_TEXTURE ? rows.find(entry.texture) : rows.end();
+        if (it == rows.end()) continue;
+        ++it->second.images;
+        it->second.refs += entry.refs;
+    }
+
+    std::vector<Row> sorted;
+    for (const auto& [texture, row] : rows) sorted.push_back(row);
+    std::sort(sorted.begin(), sorted.end(), [](const Row& a, const Row& b) {
+        return a.resident->bytes > b.resident->bytes;
+    });
+
+    out << "ImageDevice: " << residents.size() << " textures, " << memoryUsage / 1024 << " KB";
+    if (memoryBudget > 0) out << " of " << memoryBudget / 1024 << " KB budget";
+    out << std::endl;
+    for (const Row& row : sorted) {
+        out << "  " << row.resident->label << ": " << row.resident->bytes / 1024 << " KB, "
+            << row.images << (row.images == 1 ? " image, " : " images, ") << row.refs << " refs" << std::endl;
+    }
+}
+
+
+SDL_Rect AlphaMask::trim(const SDL_Rect& area) const {
+    int x0 = std::max(area.x, 0);
+    int y0 = std::max(area.y, 0);
+    int x1 = std::min(area.x + area.w, width);
+    int y1 = std::min(area.y + area.h, height);
+
+    int minX = x1, minY = y1, maxX = x0 - 1, maxY = y0 - 1;
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            if (!isVisible(x, y)) continue;
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, y);
+            maxY = y;
+        }
+    }
+    if (maxX < minX) return SDL_Rect{area.x, area.y, 0, 0};
+    return SDL_Rect{minX, minY, maxX - minX + 1, maxY - minY + 1};
+}
+
+bool AlphaMask::crop(const SDL_Rect& area, AlphaMask& out) const {
+    out = AlphaMask();
+    out.width = area.w;
+    out.height = area.h;
+    out.wordsPerRow = (area.w + 63) / 64;
+    out.bits.assign(size_t(out.wordsPerRow) * area.h, 0);
+
+    bool allVisible = true;
+    for (int y = 0; y < area.h; ++y) {
+        for (int x = 0; x < area.w; ++x) {
+            if (isVisible(area.x + x, area.y + y)) {
+                out.bits[size_t(y) * out.wordsPerRow + (x >> 6)] |= uint64_t(1) << (x & 63);
+            } else {
+                allVisible = false;
+            }
+        }
+    }
+    if (allVisible) return false;
+    out.bounds = out.trim(SDL_Rect{0, 0, out.width, out.height});
+    return true;
+}
+
+bool ImageDevice::buildAlphaMask(SDL_Surface* surface, AlphaMask& mask) {
+    // Images without an alpha channel or colour key have nothing to trim
+    if (!SDL_ISPIXELFORMAT_ALPHA(surface->format->format) && !SDL_HasColorKey(surface)) return false;
+
+    SDL_Surface* rgba = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+    if (!rgba) {
+        std::cerr << "ImageDevice: Could not read alpha: " << SDL_GetError() << std::endl;
         return false;
     }
-    
-    textures[name] = texture;
-    std::cout << "ImageDevice: Loaded texture '" << name << "' from '" << imagePath << "' region (" << srcRect.x << "," << srcRect.y << "," << srcRect.w << "," << srcRect.h << ")" << std::endl;
-    
+
+    mask = AlphaMask();
+    mask.width = rgba->w;
+    mask.height = rgba->h;
+    mask.wordsPerRow = (rgba->w + 63) / 64;
+    mask.bits.assign(size_t(mask.wordsPerRow) * rgba->h, 0);
+
+    bool allVisible = true;
+    SDL_LockSurface(rgba);
+    for (int y = 0; y < rgba->h; ++y) {
+        const Uint8* row = static_cast<const Uint8*>(rgba->pixels) + size_t(y) * rgba->pitch;
+        for (int x = 0; x < rgba->w; ++x) {
+            if (row[x * 4 + 3] != 0) {
+                mask.bits[size_t(y) * mask.wordsPerRow + (x >> 6)] |= uint64_t(1) << (x & 63);
+            } else {
+                allVisible = false;
+            }
+        }
+    }
+    SDL_UnlockSurface(rgba);
+    SDL_FreeSurface(rgba);
+
+    if (allVisible) return false;
+    mask.bounds = mask.trim(SDL_Rect{0, 0, mask.width, mask.height});
     return true;
 }
 
-SDL_Texture* ImageDevice::get(const std::string& name) {
-    auto it = textures.find(name);
-    if (it != textures.end()) {
-        return textures[name];
+const AlphaMask* ImageDevice::getAlphaMask(const std::string& name) {
+    auto it = handles.find(name);
+    return it != handles.end() ? getAlphaMask(it->second) : nullptr;
+}
+
+SDL_Texture* ImageDevice::getWhiteTexture() {
+    if (whiteTexture) return whiteTexture;
+
+    SDL_Renderer* renderer = Engine::E ? Engine::E->getRenderer() : nullptr;
+    if (!renderer) return nullptr;
+
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, 1, 1, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!surface) {
+        std::cerr << "ImageDevice: Failed to create white surface: " << SDL_GetError() << std::endl;
+        return nullptr;
     }
-    
-    std::cerr << "ImageDevice: Texture '" << name << "' not found!" << std::endl;
-    return nullptr;
+    SDL_FillRect(surface, nullptr, SDL_MapRGBA(surface->format, 255, 255, 255, 255));
+    Engine::E->runOnRenderThread([&]() {
+        whiteTexture = SDL_CreateTextureFromSurface(renderer, surface);
+    });
+    SDL_FreeSurface(surface);
+    if (!whiteTexture) {
+        std::cerr << "ImageDevice: Failed to create white texture: " << SDL_GetError() << std::endl;
+    }
+    return whiteTexture;
 }
 
+SDL_Texture* ImageDevice::getFallbackTexture() {
+    if (fallbackTexture) return fallbackTexture;
+
+    SDL_Renderer* renderer = Engine::E ? Engine::E->getRenderer() : nullptr;
+    if (!renderer) return nullptr;
+
+    // 2x2 checker, stretched over whatever the missing texture should have covered
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, 2, 2, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!surface) {
+        std::cerr << "ImageDevice: Failed to create fallback surface: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+    Uint32 magenta = SDL_MapRGBA(surface->format, 255, 0, 255, 255);
+    Uint32 black = SDL_MapRGBA(surface->format, 0, 0, 0, 255);
+    SDL_FillRect(surface, nullptr, black);
+    SDL_Rect topLeft = {0, 0, 1, 1};
+    SDL_Rect bottomRight = {1, 1, 1, 1};
+    SDL_FillRect(surface, &topLeft, magenta);
+    SDL_FillRect(surface, &bottomRight, magenta);
+    Engine::E->runOnRenderThread([&]() {
+        fallbackTexture = SDL_CreateTextureFromSurface(renderer, surface);
+        if (fallbackTexture) SDL_SetTextureScaleMode(fallbackTexture, SDL_ScaleModeNearest);
+    });
+    SDL_FreeSurface(surface);
+    if (!fallbackTexture) {
+        std::cerr << "ImageDevice: Failed to create fallback texture: " << SDL_GetError() << std::endl;
+    }
+    return fallbackTexture;
+}
 
 void ImageDevice::cleanup() {
-    for (auto& pair : textures) {
-        if (pair.second) {
-            SDL_DestroyTexture(pair.second);
-        }
+    // Joins the decoder threads and frees anything not uploaded yet
+    asyncLoader.reset();
+
+    // Every texture an entry draws from is a resident: an image of its own, a sheet or an atlas page
+    for (const auto& [texture, resident] : residents) {
+        SDL_DestroyTexture(texture);
+    }
+    residents.clear();
+    memoryUsage = 0;
+    for (TextureEntry& entry : entries) {
+        entry.texture = nullptr;
+        entry.area = SDL_Rect{0, 0, entry.area.w, entry.area.h};
+        entry.shared = false;
+    }
+    if (whiteTexture) {
+        SDL_DestroyTexture(whiteTexture);
+        whiteTexture = nullptr;
+    }
+    for (DecodedImage& image : atlasQueue) {
+        if (image.surface) SDL_FreeSurface(image.surface);
+    }
+    atlasQueue.clear();
+    if (fallbackTexture) {
+        SDL_DestroyTexture(fallbackTexture);
+        fallbackTexture = nullptr;
     }
-    textures.clear();
     std::cout << "ImageDevice: Cleaned up all textures" << std::endl;
 }
 
 bool ImageDevice::exists(const std::string& name) {
-    return textures.find(name) != textures.end();
+    auto it = handles.find(name);
+    return it != handles.end() && entries[it->second].texture != nullptr;
 }
 
+const std::string& ImageDevice::nameOf(SDL_Texture* texture) {
+    static const std::string none;
+    auto it = residents.find(texture);
+    return it != residents.end() ? it->second.label : none;
+}
+
+const std::string& ImageDevice::nameOf(TextureHandle handle) {
+    static const std::string none;
+    return handle < entries.size() ? entries[handle].name : none;
+}
@@ -1,27 +1,253 @@
 #pragma once
+#include <memory>
+#include <ostream>
 #include <string>
 #include <unordered_map>
+#include <vector>
+#include <cstdint>
 #include <SDL.h>
 
+class AsyncImageLoader;
+struct DecodedImage;
+
+// Index into ImageDevice's texture table; stays valid for the whole run
+using TextureHandle = uint32_t;
+static constexpr TextureHandle INVALID_TEXTURE = 0;
+
+/**
+ * Which pixels of a texture are visible (alpha > 0), taken from the image at load time
+ *
+ * Used to trim transparent borders: drawing only the visible part of a sprite
+ * or animation frame saves blending pixels that never change the picture.
+ */
+struct AlphaMask {
+    int width = 0;
+    int height = 0;
+    SDL_Rect bounds{0, 0, 0, 0};  // tight box around every visible pixel (w = 0 if there are none)
+    int wordsPerRow = 0;
+    std::vector<uint64_t> bits;   // one bit per pixel, each row padded to whole words
+
+    bool isVisible(int x, int y) const {
+        return (bits[size_t(y) * wordsPerRow + (x >> 6)] >> (x & 63)) & 1;
+    }
+
+    // Tight box around the visible pixels inside area (w = 0 if there are none)
+    SDL_Rect trim(const SDL_Rect& area) const;
+
+    // Mask of the part inside area; false (nothing to trim) if all of it is visible
+    bool crop(const SDL_Rect& area, AlphaMask& out) const;
+};
+
 class ImageDevice {
 public:
+    // Textures loaded from XML that fit in ATLAS_MAX_ENTRY are packed into shared atlas pages
+    static constexpr int ATLAS_PAGE_SIZE = 2048;  // clamped to the renderer's limit
+    static constexpr int ATLAS_MAX_ENTRY = 512;
+    static constexpr int ATLAS_PADDING = 1;       // transparent pixels between regions
+    static constexpr int ATLAS_EXTRUDE = 1;       // copies of each region's edge pixels around it
+
     // Load texture from image file with optional source rectangle
+    // (the file is loaded once, under its path, and the rectangle becomes a region of it)
     static bool load(const std::string& name, const std::string& imagePath);
     static bool load(const std::string& name, const std::string& imagePath, SDL_Rect srcRect);
+
+    /**
+     * Name a rectangle of a loaded texture (or of another region)
+     *
+     * The region draws from its parent's SDL texture through a source rect, so
+     * slicing a sheet costs no decoding, uploading or texture memory. Declared in
+     * asset XML as <Region name="..." texture="..." rect="x,y,w,h"/>. The parent
+     * only has to be registered; the region follows it in and out of memory.
+     */
+    static bool defineRegion(const std::string& name, const std::string& parent, SDL_Rect rect);
     
-    // Get texture by name
+    /**
+     * Handle for a texture name, resolved once when a component is created or loaded
+     *
+     * Names that are not loaded (yet) still get a handle: the slot is filled
+     * when a texture of that name arrives, and draws the fallback until then.
+     */
+    static TextureHandle getHandle(const std::string& name);
+
+    // Texture of a handle, the shared fallback when it is missing. Meant for per-frame use
+    static SDL_Texture* get(TextureHandle handle) {
+        if (handle >= entries.size()) return missing(handle);
+        TextureEntry& entry = entries[handle];
+        entry.lastUsed = useClock; // drawn this frame, last in line for eviction
+        return entry.texture ? entry.texture : missing(handle);
+    }
+
+    // Advance the clock get() stamps textures with; once per rendered frame
+    static void beginFrame() { ++useClock; }
+
+    // Get texture by name, streamed in if registered (nullptr if unknown); load-time use, draws should hold a handle
     static SDL_Texture* get(const std::string& name);
 
-    // Load multiple textures from an XML file
+    // Visible pixels of a texture, nullptr when every pixel is opaque (or the texture is unknown)
+    static const AlphaMask* getAlphaMask(TextureHandle handle) {
+        return handle < entries.size() && entries[handle].hasMask ? &entries[handle].mask : nullptr;
+    }
+    static const AlphaMask* getAlphaMask(const std::string& name);
+
+    // Part of get(handle) the image occupies (atlas or sheet region), nullptr for a whole texture
+    static const SDL_Rect* getRegion(TextureHandle handle) {
+        return handle < entries.size() && entries[handle].shared ? &entries[handle].area : nullptr;
+    }
+
+    // Image rectangle inside its SDL texture ({0, 0, w, h} unless shared; empty if never loaded)
+    static SDL_Rect getArea(TextureHandle handle) {
+        return handle < entries.size() ? entries[handle].area : SDL_Rect{0, 0, 0, 0};
+    }
+
+    // Fill mask from a surface's alpha; false (nothing to trim) if every pixel is visible. Any thread
+    static bool buildAlphaMask(SDL_Surface* surface, AlphaMask& mask);
+
+    // Create and register a texture from a decoded surface, taking over the mask if given
+    static bool upload(const std::string& name, SDL_Surface* surface, AlphaMask* mask);
+
+    // Shared 1x1 white texture for solid-colour quads (tint with vertex/colour mod)
+    static SDL_Texture* getWhiteTexture();
+
+    // Shared magenta/black checker drawn in place of missing textures
+    static SDL_Texture* getFallbackTexture();
+
+    // Load multiple textures from an XML file (the background load, waited for)
     static bool loadFromXML(const std::string& xmlPath);
+
+    /**
+     * Record the textures and regions of an XML file without loading any of them
+     *
+     * Registered names get handles at once; their textures are made resident
+     * by require(), prefetch(), or the first draw that finds them missing.
+     * @param textures If given, receives the names of the file's <Texture>s
+     */
+    static bool registerFromXML(const std::string& xmlPath, std::vector<std::string>* textures = nullptr);
+
+    /**
+     * Start loading the textures of an XML file in the background
+     *
+     * Files are decoded on worker threads; updateAsyncLoads() turns the decoded
+     * images into textures a few at a time, so the caller can keep drawing
+     * frames (a menu, a progress bar) while the rest arrives. A second call
+     * first finishes the batch still in flight.
+     *
+     * Small textures are held back and packed into atlas pages once the whole
+     * batch is decoded, so most sprites end up sharing one or two textures.
+     * <Texture atlas="false"> keeps a texture on its own.
+     */
+    static bool loadFromXMLAsync(const std::string& xmlPath);
+
+    // Upload decoded images until budgetMs is spent (at least one per call); true while loading
+    static bool updateAsyncLoads(double budgetMs);
+
+    // Block until every pending background load is a texture
+    static void finishAsyncLoads();
+
+    static bool isLoading();
+    // Fraction of the background batch that is uploaded, 1 when idle
+    static float getLoadProgress();
+
+    /**
+     * Residency: which registered textures are in texture memory
+     *
+     * A level require()s its textures, which holds a reference on each and
+     * loads the missing ones (as one batch, so small ones share atlas pages).
+     * Releasing the references of the previous level makes its textures
+     * candidates for eviction: trimToBudget() destroys unreferenced textures,
+     * least recently used first, until usage is within the memory budget.
+     * An atlas page or a sheet is evicted as a whole, once nothing on it is
+     * referenced. Evicted textures keep their handles and come back on demand.
+     */
+    static std::vector<TextureHandle> require(const std::vector<std::string>& names);
+    // Start loading the textures that are not resident in the background (e.g. the next level's)
+    static void prefetch(const std::vector<std::string>& names);
+    static void acquire(TextureHandle handle);
+    static void release(TextureHandle handle);
+    static void release(const std::vector<TextureHandle>& handles);
+    // Load the image behind a handle now, on its own texture; false if it cannot be loaded
+    static bool ensureResident(TextureHandle handle);
+    static bool isResident(TextureHandle handle) { return handle < entries.size() && entries[handle].texture; }
+    // Whether a handle has anything to load (a file, a parent, or a texture uploaded directly)
+    static bool isRegistered(TextureHandle handle);
+    static int getRefCount(TextureHandle handle);
+    // Evict unreferenced textures, least recently used first, until usage fits the budget
+    static void trimToBudget();
+
+    // Texture memory budget in bytes (0 = unlimited)
+    static void setMemoryBudget(size_t bytes) { memoryBudget = bytes; }
+    static size_t getMemoryBudget() { return memoryBudget; }
+    // Bytes of texture memory held by every resident texture
+    static size_t getMemoryUsage() { return memoryUsage; }
+    // Bytes a texture accounts for (its share of the page for atlas and sheet regions)
+    static size_t getMemoryUsage(TextureHandle handle);
+    // Every resident texture with its size and references, largest first
+    static void printMemory(std::ostream& out);
     
-    // Cleanup all textures
+    // Cleanup all textures (handles and registrations stay valid; textures are loaded again on demand)
     static void cleanup();
     
-    // Check if texture exists
+    // Check if texture is resident
     static bool exists(const std::string& name);
 
+    // Name a texture was loaded under (empty if unknown); a linear search, meant for reports
+    static const std::string& nameOf(SDL_Texture* texture);
+    static const std::string& nameOf(TextureHandle handle);
+
 private:
-    static std::unordered_map<std::string, SDL_Texture*> textures;
-};
+    struct TextureEntry {
+        std::string name;
+        std::string file;                       // image it is (re)loaded from; empty if it cannot be
+        TextureHandle parent = INVALID_TEXTURE; // regions: texture they are cut from
+        SDL_Rect regionRect{0, 0, 0, 0};        // regions: rectangle in the parent
+        SDL_Texture* texture = nullptr;
+        SDL_Rect area{0, 0, 0, 0};  // image inside texture; size kept while evicted
+        bool shared = false;        // texture is an atlas page or a parent's; not owned by this entry
+        bool atlasAllowed = true;
+        AlphaMask mask;             // kept while evicted, so trimming survives a reload
+        bool hasMask = false;
+        bool reported = false;  // missing texture already reported
+        int refs = 0;           // on the root entry; regions forward to their parent
+        uint64_t lastUsed = 0;
+    };
+
+    // An SDL texture in memory: a whole image, a sheet or an atlas page
+    struct Resident {
+        std::string label;  // texture name, or atlasN for pages
+        size_t bytes = 0;
+    };
+
+    // Slow path of get(handle): stream the texture in, or report the miss once and hand out the fallback
+    static SDL_Texture* missing(TextureHandle handle);
+
+    // Pack the held-back images into atlas pages and register their regions
+    static void buildAtlases();
+
+    // Decode files in the background (the loader is created on first use)
+    static void startBatch(std::vector<std::pair<std::string, std::string>> files);
 
+    // Entry that owns the image of a handle (follows region parents)
+    static TextureHandle rootOf(TextureHandle handle);
+    // Files of the non-resident roots of names, each once
+    static std::vector<std::pair<std::string, std::string>> missingFiles(const std::vector<std::string>& names);
+
+    // Point the regions cut from handle (and theirs) at its current texture
+    static void refreshRegions(TextureHandle handle);
+    static void cutRegion(TextureHandle handle);
+
+    static void addResident(SDL_Texture* texture, const std::string& label);
+    // Destroy a resident texture and clear every entry drawing from it
+    static void evict(SDL_Texture* texture);
+
+    static std::vector<TextureEntry> entries;  // indexed by handle; entry 0 is INVALID_TEXTURE
+    static std::unordered_map<std::string, TextureHandle> handles;
+    static SDL_Texture* whiteTexture;
+    static SDL_Texture* fallbackTexture;
+    static std::unique_ptr<AsyncImageLoader> asyncLoader;
+    static Uint32 uploadFormat;                   // first renderer format with alpha, set by startBatch
+    static std::vector<DecodedImage> atlasQueue;  // decoded, waiting for the batch to be packed
+    static std::unordered_map<SDL_Texture*, Resident> residents;
+    static size_t memoryUsage;
+    static size_t memoryBudget;
+    static uint64_t useClock;  // orders lastUsed: frames, loads, acquires and releases
+    static int atlasCount;     // pages created so far, for their labels
+};
@@ -2,6 +2,9 @@
 #include "tinyxml2.h"
 #include <iostream>
 #include <unordered_map>
+#include <cstdlib>
+#include <sstream>
+#include <algorithm>
 
 #include "BodyComponent.h"
 #include "SpriteComponent.h"
@@ -9,6 +12,8 @@
 #include "CharacterComponent.h"
 #include "GroundComponent.h"
 #include "AnimateComponent.h"
+#include "AnimatorComponent.h"
+#include "ParticleEmitterComponent.h"
 #include "KeyComponent.h"
 #include "DoorComponent.h"
 #include "HealthComponent.h"
@@ -29,6 +34,88 @@ bool LevelLoader::load(const std::string& filename, Engine& engine)
         return false;
     }
 
+    // Every texture the level draws is resident before its objects are created
+    engine.requireLevelTextures(filename);
+
+    // A freshly loaded level is live gameplay again
+    engine.unfreeze();
+
+    // Parallax backgrounds belong to the level
+    engine.clearParallaxLayers();
+    for (XMLElement* layerElem = level->FirstChildElement("ParallaxLayer");
+         layerElem; layerElem = layerElem->NextSiblingElement("ParallaxLayer"))
+    {
+        const char* image = layerElem->Attribute("image");
+        if (!image) {
+            std::cerr << "ParallaxLayer missing image attribute in " << filename << std::endl;
+            continue;
+        }
+
+        ParallaxLayer layer;
+        layer.textureName = image;
+        layer.factor = layerElem->FloatAttribute("factor", 0.0f);
+        layer.x = layerElem->FloatAttribute("x", 0.0f);
+        layer.y = layerElem->FloatAttribute("y", 0.0f);
+        layer.width = layerElem->FloatAttribute("w", 0.0f);
+        layer.height = layerElem->FloatAttribute("h", 0.0f);
+        layer.repeat = ParallaxLayer::parseRepeat(layerElem->Attribute("repeat"));
+        layer.opaque = layerElem->BoolAttribute("opaque", false);
+        engine.addParallaxLayer(layer);
+    }
+
+    // Tile layers: indices come from <Fill> rectangles and comma separated <Data> rows (-1 = empty)
+    engine.clearTileMaps();
+    for (XMLElement* mapElem = level->FirstChildElement("TileMap");
+         mapElem; mapElem = mapElem->NextSiblingElement("TileMap"))
+    {
+        const char* tileset = mapElem->Attribute("tileset");
+        if (!tileset) {
+            std::cerr << "TileMap missing tileset attribute in " << filename << std::endl;
+            continue;
+        }
+
+        auto map = std::make_unique<TileMap>(mapElem->IntAttribute("cols", 0), mapElem->IntAttribute("rows", 0),
+                                             mapElem->FloatAttribute("tileSize", 32.0f),
+                                             mapElem->FloatAttribute("x", 0.0f), mapElem->FloatAttribute("y", 0.0f));
+        if (!map->setTileset(tileset, mapElem->IntAttribute("sourceTileSize", 16), mapElem->IntAttribute("spacing", 0))) {
+            std::cerr << "TileMap tileset '" << tileset << "' is not loaded" << std::endl;
+            continue;
+        }
+        if (mapElem->Attribute("depth")) {
+            map->setDepth(uint16_t(mapElem->UnsignedAttribute("depth")));
+        }
+
+        for (XMLElement* fill = mapElem->FirstChildElement("Fill"); fill; fill = fill->NextSiblingElement("Fill")) {
+            map->fill(fill->IntAttribute("col", 0), fill->IntAttribute("row", 0),
+                      fill->IntAttribute("cols", 1), fill->IntAttribute("rows", 1),
+                      uint16_t(fill->IntAttribute("tile", -1)));
+        }
+        for (XMLElement* data = mapElem->FirstChildElement("Data"); data; data = data->NextSiblingElement("Data")) {
+            int row = data->IntAttribute("row", 0);
+            int col = data->IntAttribute("col", 0);
+            const char* text = data->GetText();
+            while (text && *text) {
+                char* end = nullptr;
+                long tile = std::strtol(text, &end, 10);
+                if (end == text) break;
+                map->setTile(col++, row, uint16_t(tile < 0 ? TileMap::EMPTY : tile));
+                text = end;
+                while (*text == ',' || *text == ' ' || *text == '\n' || *text == '\r' || *text == '\t') ++text;
+            }
+        }
+        // nonSolid="3 4 5": decoration tiles without collision
+        if (const char* nonSolid = mapElem->Attribute("nonSolid")) {
+            std::istringstream in(nonSolid);
+            int tile;
+            while (in >> tile) map->setSolid(uint16_t(tile), false);
+        }
+
+        map->buildCollision(engine.getWorldId(), float(engine.getWorldHeight()));
+        std::cout << "LevelLoader: TileMap " << map->getColumns() << "x" << map->getRows()
+                  << " with " << map->getShapeCount() << " collision shapes" << std::endl;
+        engine.addTileMap(std::move(map));
+    }
+
     std::unordered_map<std::string, Object*> idMap;
 
     // Pass 1 — create all objects and add basic components
@@ -104,6 +191,11 @@ bool LevelLoader::load(const std::string& filename, Engine& engine)
                         float parallax = comp->FloatAttribute("parallax", 1.0f);
                         sprite->setParallax(parallax);
                     }
+                    
+                    // Parse draw depth (world layer ordering)
+                    if (comp->Attribute("depth")) {
+                        sprite->setDepth(uint16_t(comp->UnsignedAttribute("depth", RenderQueue::DEFAULT_WORLD_DEPTH)));
+                    }
                 }
             }
             else if (compName == "CharacterComponent") {
@@ -124,17 +216,50 @@ bool LevelLoader::load(const std::string& filename, Engine& engine)
                 obj->addComponent<HealthComponent>(maxHealth);
             }
             else if (compName == "AnimateComponent") {
+                // A named clip from the animation library, or a sheet described inline
+                AnimateComponent* animate = nullptr;
+                const char* clip = comp->Attribute("clip");
                 const char* image = comp->Attribute("image");
-                if (image) {
+                if (clip) {
+                    ClipId clipId = AnimationLibrary::find(clip);
+                    if (clipId == INVALID_CLIP) {
+                        std::cerr << "LevelLoader: Unknown animation clip '" << clip << "'" << std::endl;
+                    }
+                    animate = obj->addComponent<AnimateComponent>(clipId);
+                }
+                else if (image) {
                     int frames = comp->IntAttribute("frames", 1);
                     float time = comp->FloatAttribute("time", 0.1f);
-
-                    // obj->addComponent<AnimateComponent>(image, frames, time);
-                    
                     int frameWidth = comp->IntAttribute("frameWidth", 0);
                     int frameHeight = comp->IntAttribute("frameHeight", 0);
                     int frameSpacing = comp->IntAttribute("frameSpacing", 0);
-                    obj->addComponent<AnimateComponent>(image, frames, time, frameWidth, frameHeight, frameSpacing);
+                    animate = obj->addComponent<AnimateComponent>(image, frames, time, frameWidth, frameHeight, frameSpacing);
+                }
+                if (animate && comp->Attribute("depth")) {
+                    animate->setDepth(uint16_t(comp->UnsignedAttribute("depth", RenderQueue::DEFAULT_WORLD_DEPTH)));
+                }
+                if (animate) {
+                    animate->setRate(comp->FloatAttribute("rate", 1.0f));
+                    // phase="random" spreads identical sprites across the clip
+                    const char* phase = comp->Attribute("phase");
+                    if (phase && std::string(phase) == "random") animate->randomizePhase();
+                    else if (phase) animate->setPhase(comp->FloatAttribute("phase", 0.0f));
+                }
+            }
+            else if (compName == "ParticleEmitterComponent") {
+                const char* emitter = comp->Attribute("emitter");
+                if (emitter) {
+                    obj->addComponent<ParticleEmitterComponent>(emitter,
+                        comp->FloatAttribute("offsetX", 0.0f), comp->FloatAttribute("offsetY", 0.0f));
+                }
+            }
+            else if (compName == "AnimatorComponent") {
+                const char* machine = comp->Attribute("machine");
+                MachineId machineId = machine ? AnimationStateMachine::find(machine) : INVALID_MACHINE;
+                if (machineId == INVALID_MACHINE) {
+                    std::cerr << "LevelLoader: Unknown animation state machine '" << (machine ? machine : "") << "'" << std::endl;
+                } else {
+                    obj->addComponent<AnimatorComponent>(machineId);
                 }
             }
 
@@ -175,6 +300,61 @@ bool LevelLoader::load(const std::string& filename, Engine& engine)
                 obj->addComponent<MissileComponent>(idMap[targetId]);
         }
     }
+    // The previous level's textures are no longer referenced; evict what the budget cannot keep
+    ImageDevice::trimToBudget();
     std::cout << "Loaded level: " << filename << std::endl;
     return true;
 }
+
+std::vector<std::string> LevelLoader::collectTextures(const std::string& filename)
+{
+    std::vector<std::string> names;
+    XMLDocument doc;
+    if (doc.LoadFile(filename.c_str()) != XML_SUCCESS) return names;
+    XMLElement* level = doc.FirstChildElement("Level");
+    if (!level) return names;
+
+    auto addClip = [&names](ClipId clip) {
+        if (AnimationLibrary::isValid(clip)) names.push_back(AnimationLibrary::get(clip).textureName);
+    };
+
+    for (XMLElement* layerElem = level->FirstChildElement("ParallaxLayer");
+         layerElem; layerElem = layerElem->NextSiblingElement("ParallaxLayer"))
+    {
+        if (const char* image = layerElem->Attribute("image")) names.push_back(image);
+    }
+    for (XMLElement* mapElem = level->FirstChildElement("TileMap");
+         mapElem; mapElem = mapElem->NextSiblingElement("TileMap"))
+    {
+        if (const char* tileset = mapElem->Attribute("tileset")) names.push_back(tileset);
+    }
+    for (XMLElement* objElem = level->FirstChildElement("GameObject");
+         objElem; objElem = objElem->NextSiblingElement("GameObject"))
+    {
+        for (XMLElement* comp = objElem->FirstChildElement();
+             comp; comp = comp->NextSiblingElement())
+        {
+            std::string compName = comp->Name();
+            if (compName == "SpriteComponent") {
+                const char* image = comp->Attribute("image");
+                // Solid colours written by SaveGame have no texture
+                if (image && std::string(image).find("_COLOR_") != 0) names.push_back(image);
+            }
+            else if (compName == "AnimateComponent") {
+                if (const char* clip = comp->Attribute("clip")) addClip(AnimationLibrary::find(clip));
+                else if (const char* image = comp->Attribute("image")) names.push_back(image);
+            }
+            else if (compName == "AnimatorComponent") {
+                const char* machine = comp->Attribute("machine");
+                MachineId machineId = machine ? AnimationStateMachine::find(machine) : INVALID_MACHINE;
+                if (machineId == INVALID_MACHINE) continue;
+                for (const AnimState& state : AnimationStateMachine::get(machineId).states) addClip(state.clip);
+            }
+        }
+    }
+
+    // Shared sheets show up once per user
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    return names;
+}
@@ -1,8 +1,12 @@
 #pragma once
 #include <string>
+#include <vector>
 #include "Engine.h"
 
 class LevelLoader {
 public:
     static bool load(const std::string& filename, Engine& engine);
+
+    // Names of every texture a level file draws (layers, tile sets, sprites, clips and state machines)
+    static std::vector<std::string> collectTextures(const std::string& filename);
 };
@@ -1,40 +1,22 @@
 #include "Menu.h"
+#include "Engine.h"
+#include "TextRenderer.h"
 #include <iostream>
 
-Menu::Menu(SDL_Renderer* renderer, int screenWidth, int screenHeight)
-    : renderer(renderer), screenWidth(screenWidth), screenHeight(screenHeight),
-      currentState(MenuState::MAIN_MENU), selectedIndex(0), font(nullptr), titleFont(nullptr)
+Menu::Menu(int screenWidth, int screenHeight)
+    : screenWidth(screenWidth), screenHeight(screenHeight),
+      currentState(MenuState::MAIN_MENU), selectedIndex(0)
 {
-    // Initialize SDL_ttf if not already done
-    if (TTF_WasInit() == 0) {
-        if (TTF_Init() == -1) {
-            std::cerr << "TTF_Init failed: " << TTF_GetError() << std::endl;
-        }
-    }
-
-    // Try to load fonts (using default system fonts or fallback)
-    // On Windows, try common font paths
-    const char* fontPaths[] = {
-        "C:/Windows/Fonts/arial.ttf",
-        "C:/Windows/Fonts/calibri.ttf",
-        "C:/Windows/Fonts/times.ttf",
-        "C:/Windows/Fonts/cour.ttf",
-        nullptr
-    };
-
-    // Try to load title font
-    for (int i = 0; fontPaths[i] != nullptr && !titleFont; ++i) {
-        titleFont = TTF_OpenFont(fontPaths[i], 72);
-    }
-    if (!titleFont) {
+    // Fonts ship with the game, so text works on every platform
+    if (TextRenderer::loadFont("title", TextRenderer::DEFAULT_FONT_PATH, 72)) {
+        titleFont = "title";
+    } else {
         std::cerr << "Warning: Could not load title font. Menu will use rectangles instead of text." << std::endl;
     }
 
-    // Try to load menu font
-    for (int i = 0; fontPaths[i] != nullptr && !font; ++i) {
-        font = TTF_OpenFont(fontPaths[i], 36);
-    }
-    if (!font) {
+    if (TextRenderer::loadFont("menu", TextRenderer::DEFAULT_FONT_PATH, 36)) {
+        font = "menu";
+    } else {
         std::cerr << "Warning: Could not load menu font. Menu will use rectangles instead of text." << std::endl;
     }
 
@@ -43,19 +25,12 @@ Menu::Menu(SDL_Renderer* renderer, int screenWidth, int screenHeight)
 }
 
 Menu::~Menu() {
-    if (font) {
-        TTF_CloseFont(font);
-    }
-    if (titleFont) {
-        TTF_CloseFont(titleFont);
-    }
 }
 
 void Menu::render() {
     if (currentState == MenuState::MAIN_MENU) {
         // Clear screen with dark background
-        SDL_SetRenderDrawColor(renderer, 20, 20, 40, 255);
-        SDL_RenderClear(renderer);
+        renderBackground();
 
         // Draw title
         SDL_Color titleColor = {255, 255, 100, 255}; // Yellow
@@ -63,9 +38,7 @@ void Menu::render() {
             renderText("GIGI GAME", screenWidth / 2, 150, titleFont, titleColor);
         } else {
             // Fallback: draw title as rectangle
-            SDL_Rect titleRect = {screenWidth / 2 - 200, 100, 400, 80};
-            SDL_SetRenderDrawColor(renderer, titleColor.r, titleColor.g, titleColor.b, titleColor.a);
-            SDL_RenderFillRect(renderer, &titleRect);
+            fillRect(SDL_Rect{screenWidth / 2 - 200, 100, 400, 80}, titleColor);
         }
 
         // Draw menu items
@@ -84,14 +57,10 @@ void Menu::render() {
                 renderText(menuItems[i], screenWidth / 2, startY + (int)i * spacing, font, color);
             } else {
                 // Fallback: draw rectangles if font not available
-                SDL_Rect rect = {screenWidth / 2 - 100, startY + (int)i * spacing - 20, 200, 40};
-                SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-                SDL_RenderFillRect(renderer, &rect);
+                fillRect(SDL_Rect{screenWidth / 2 - 100, startY + (int)i * spacing - 20, 200, 40}, color);
                 // Draw a small indicator for selected item
                 if (i == selectedIndex) {
-                    SDL_Rect indicator = {screenWidth / 2 - 120, startY + (int)i * spacing - 10, 20, 20};
-                    SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
-                    SDL_RenderFillRect(renderer, &indicator);
+                    fillRect(SDL_Rect{screenWidth / 2 - 120, startY + (int)i * spacing - 10, 20, 20}, SDL_Color{255, 255, 0, 255});
                 }
             }
         }
@@ -102,10 +71,20 @@ void Menu::render() {
             renderText("Use Arrow Keys to navigate, Enter to select", 
                       screenWidth / 2, screenHeight - 100, font, instructionColor);
         }
+
+        // Textures still arriving in the background
+        if (loadProgress < 1.0f) {
+            int percent = int(loadProgress * 100.0f);
+            if (font) {
+                renderText("Loading assets " + std::to_string(percent) + "%",
+                           screenWidth / 2, screenHeight - 50, font, instructionColor);
+            } else {
+                fillRect(SDL_Rect{screenWidth / 2 - 100, screenHeight - 60, 2 * percent, 10}, instructionColor);
+            }
+        }
     } else if (currentState == MenuState::OPTIONS) {
         // Options menu
-        SDL_SetRenderDrawColor(renderer, 20, 20, 40, 255);
-        SDL_RenderClear(renderer);
+        renderBackground();
 
         SDL_Color titleColor = {255, 255, 100, 255};
         if (titleFont) {
@@ -119,8 +98,7 @@ void Menu::render() {
         }
     } else if (currentState == MenuState::PAUSE_MENU) {
         // Pause menu 
-        SDL_SetRenderDrawColor(renderer, 20, 20, 40, 255);
-        SDL_RenderClear(renderer);
+        renderBackground();
 
         // Draw title
         SDL_Color titleColor = {255, 255, 100, 255}; // Yellow
@@ -128,9 +106,7 @@ void Menu::render() {
             renderText("PAUSED", screenWidth / 2, 150, titleFont, titleColor);
         } else {
             // Fallback: draw title as rectangle
-            SDL_Rect titleRect = {screenWidth / 2 - 200, 100, 400, 80};
-            SDL_SetRenderDrawColor(renderer, titleColor.r, titleColor.g, titleColor.b, titleColor.a);
-            SDL_RenderFillRect(renderer, &titleRect);
+            fillRect(SDL_Rect{screenWidth / 2 - 200, 100, 400, 80}, titleColor);
         }
 
         // Draw pause menu items
@@ -150,14 +126,10 @@ void Menu::render() {
                 renderText(pauseItems[i], screenWidth / 2, startY + (int)i * spacing, font, color);
             } else {
                 // Fallback: draw rectangles if font not available
-                SDL_Rect rect = {screenWidth / 2 - 100, startY + (int)i * spacing - 20, 200, 40};
-                SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-                SDL_RenderFillRect(renderer, &rect);
+                fillRect(SDL_Rect{screenWidth / 2 - 100, startY + (int)i * spacing - 20, 200, 40}, color);
                 // Draw a small indicator for selected item
                 if (i == selectedIndex) {
-                    SDL_Rect indicator = {screenWidth / 2 - 120, startY + (int)i * spacing - 10, 20, 20};
-                    SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
-                    SDL_RenderFillRect(renderer, &indicator);
+                    fillRect(SDL_Rect{screenWidth / 2 - 120, startY + (int)i * spacing - 10, 20, 20}, SDL_Color{255, 255, 0, 255});
                 }
             }
         }
@@ -238,31 +210,25 @@ MenuAction Menu::handleInput() {
     return MenuAction::NONE;
 }
 
-void Menu::renderText(const std::string& text, int x, int y, TTF_Font* font, SDL_Color color) {
-    SDL_Texture* texture = createTextTexture(text, font, color);
-    if (!texture) return;
-
-    int texW, texH;
-    SDL_QueryTexture(texture, NULL, NULL, &texW, &texH);
-
-    SDL_Rect dstRect = {x - texW / 2, y - texH / 2, texW, texH};
-    SDL_RenderCopy(renderer, texture, NULL, &dstRect);
-
-    SDL_DestroyTexture(texture);
+void Menu::renderBackground() {
+    // The pause menu dims the frozen game behind it; the others cover the whole screen
+    if (currentState == MenuState::PAUSE_MENU) {
+        Engine::E->fillScreenRect(RenderLayer::HUD, 0, SDL_Rect{0, 0, screenWidth, screenHeight},
+                                  SDL_Color{0, 0, 0, 160});
+        return;
+    }
+    Engine::E->fillScreenRect(RenderLayer::Background, 0, SDL_Rect{0, 0, screenWidth, screenHeight},
+                              SDL_Color{20, 20, 40, 255});
 }
 
-SDL_Texture* Menu::createTextTexture(const std::string& text, TTF_Font* font, SDL_Color color) {
-    if (!font) return nullptr;
-
-    SDL_Surface* surface = TTF_RenderText_Solid(font, text.c_str(), color);
-    if (!surface) {
-        std::cerr << "TTF_RenderText_Solid failed: " << TTF_GetError() << std::endl;
-        return nullptr;
-    }
+void Menu::fillRect(const SDL_Rect& rect, SDL_Color color) {
+    Engine::E->fillScreenRect(RenderLayer::HUD, 0, rect, color);
+}
 
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
+void Menu::renderText(const std::string& text, int x, int y, const char* font, SDL_Color color) {
+    if (!font) return;
 
-    return texture;
+    // Centred on (x, y); layouts and the glyph atlas are reused every frame
+    SDL_Point size = TextRenderer::measure(font, text);
+    TextRenderer::draw(font, text, float(x), y - size.y / 2.0f, color, TextAlign::Center, RenderLayer::HUD, 1);
 }
-
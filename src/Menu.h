@@ -1,6 +1,5 @@
 #pragma once
 #include <SDL.h>
-#include <SDL_ttf.h>
 #include <string>
 #include <vector>
 
@@ -24,10 +23,10 @@ enum class MenuAction {
 
 class Menu {
 public:
-    Menu(SDL_Renderer* renderer, int screenWidth, int screenHeight);
+    Menu(int screenWidth, int screenHeight);
     ~Menu();
 
-    void render();
+    void render(); // Queues the menu on the engine's render queue
     MenuAction handleInput();
     MenuState getState() const { return currentState; }
     void setState(MenuState state) { 
@@ -38,21 +37,26 @@ public:
     }
     void setSelectedIndex(int index) { selectedIndex = index; }
     
+    // Share of the assets loaded so far; the main menu shows it until it reaches 1
+    void setLoadProgress(float progress) { loadProgress = progress; }
+
     bool isInMenu() const { return currentState == MenuState::MAIN_MENU || currentState == MenuState::OPTIONS; }
 
 private:
-    SDL_Renderer* renderer;
     int screenWidth;
     int screenHeight;
     
-    TTF_Font* font;
-    TTF_Font* titleFont;
+    // Names of the TextRenderer fonts, nullptr when they failed to load
+    const char* font = nullptr;
+    const char* titleFont = nullptr;
     
     MenuState currentState;
     int selectedIndex;
     std::vector<std::string> menuItems;
+    float loadProgress = 1.0f;
     
-    void renderText(const std::string& text, int x, int y, TTF_Font* font, SDL_Color color);
-    SDL_Texture* createTextTexture(const std::string& text, TTF_Font* font, SDL_Color color);
+    void renderBackground();
+    void fillRect(const SDL_Rect& rect, SDL_Color color);
+    void renderText(const std::string& text, int x, int y, const char* font, SDL_Color color);
 };
 
@@ -62,6 +62,8 @@ public:
     template<typename T>
     bool hasComponent() { return getComponent<T>() != nullptr; }
 
+    size_t getComponentCount() const { return components.size(); }
+
 
 
 
@@ -0,0 +1,86 @@
+#include "ParallaxLayer.h"
+#include "ImageDevice.h"
+#include "RenderQueue.h"
+#include "View.h"
+#include <cmath>
+#include <cstring>
+
+ParallaxRepeat ParallaxLayer::parseRepeat(const char* value) {
+    if (!value) return ParallaxRepeat::X;
+    if (std::strcmp(value, "none") == 0) return ParallaxRepeat::None;
+    if (std::strcmp(value, "y") == 0) return ParallaxRepeat::Y;
+    if (std::strcmp(value, "xy") == 0) return ParallaxRepeat::XY;
+    return ParallaxRepeat::X;
+}
+
+void ParallaxLayer::getTileSize(float& w, float& h) const {
+    w = width;
+    h = height;
+    if (w > 0.0f && h > 0.0f) return;
+
+    SDL_Rect area = ImageDevice::getArea(texture);
+    if (w <= 0.0f) w = float(area.w);
+    if (h <= 0.0f) h = float(area.h);
+}
+
+bool ParallaxLayer::coversScreen(const View& view) const {
+    if (!opaque) return false;
+
+    float w, h;
+    getTileSize(w, h);
+    if (w <= 0.0f || h <= 0.0f) return false;
+
+    bool repeatX = (repeat == ParallaxRepeat::X || repeat == ParallaxRepeat::XY);
+    bool repeatY = (repeat == ParallaxRepeat::Y || repeat == ParallaxRepeat::XY);
+
+    float left = x - view.x * factor;
+    float top = y - view.y * factor;
+    bool coversX = repeatX || (left <= 0.0f && left + w >= view.screenWidth);
+    bool coversY = repeatY || (top <= 0.0f && top + h >= view.screenHeight);
+    return coversX && coversY;
+}
+
+void ParallaxLayer::submit(const View& view, RenderQueue& queue) const {
+    SDL_Texture* tex = ImageDevice::get(texture);
+    if (!tex) return;
+    const SDL_Rect* src = ImageDevice::getRegion(texture);
+
+    float w, h;
+    getTileSize(w, h);
+    if (w <= 0.0f || h <= 0.0f) return;
+
+    bool repeatX = (repeat == ParallaxRepeat::X || repeat == ParallaxRepeat::XY);
+    bool repeatY = (repeat == ParallaxRepeat::Y || repeat == ParallaxRepeat::XY);
+
+    // Screen position of the first tile
+    float left = x - view.x * factor;
+    float top = y - view.y * factor;
+
+    // Range of tile indices that overlaps the screen
+    int firstX = 0, lastX = 0, firstY = 0, lastY = 0;
+    if (repeatX) {
+        firstX = (int)std::floor(-left / w);
+        lastX = (int)std::floor((view.screenWidth - left) / w);
+    } else if (left >= view.screenWidth || left + w <= 0.0f) {
+        return;
+    }
+    if (repeatY) {
+        firstY = (int)std::floor(-top / h);
+        lastY = (int)std::floor((view.screenHeight - top) / h);
+    } else if (top >= view.screenHeight || top + h <= 0.0f) {
+        return;
+    }
+
+    // An opaque layer needs no blending
+    SDL_BlendMode blend = opaque ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND;
+    uint16_t depth = RenderQueue::depthFromParallax(factor);
+
+    for (int ty = firstY; ty <= lastY; ++ty) {
+        for (int tx = firstX; tx <= lastX; ++tx) {
+            // Round the origin so neighbouring tiles never leave a seam
+            SDL_FRect dst = {std::floor(left + tx * w), std::floor(top + ty * h), w, h};
+            queue.submit(RenderLayer::Background, depth, 0.0f, tex, src, dst,
+                         0.0f, SDL_FLIP_NONE, SDL_Color{255, 255, 255, 255}, blend);
+        }
+    }
+}
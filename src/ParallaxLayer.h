@@ -0,0 +1,47 @@
+#pragma once
+#include <SDL.h>
+#include <string>
+#include "ImageDevice.h"
+
+class View;
+class RenderQueue;
+
+enum class ParallaxRepeat {
+    None,
+    X,
+    Y,
+    XY
+};
+
+/**
+ * ParallaxLayer - A tiled background image that scrolls at a fraction of the camera speed
+ *
+ * Declared in level XML:
+ *   <ParallaxLayer image="sky" factor="0.0" y="0" w="1920" h="1080" repeat="x" opaque="true"/>
+ *
+ * Each frame the exact set of tile copies covering the screen is computed from
+ * the camera position; the layer itself holds no per-frame state.
+ */
+class ParallaxLayer {
+public:
+    std::string textureName;
+    TextureHandle texture = INVALID_TEXTURE; // resolved when the layer is added to the engine
+    float factor = 0.0f;     // 0 = fixed to the screen, 1 = moves with the world
+    float x = 0.0f;          // offset of the first tile
+    float y = 0.0f;
+    float width = 0.0f;      // tile size (0 = texture size)
+    float height = 0.0f;
+    ParallaxRepeat repeat = ParallaxRepeat::X;
+    bool opaque = false;     // every pixel is opaque (lets layers behind it be skipped)
+
+    static ParallaxRepeat parseRepeat(const char* value);
+
+    // Tile size, falling back to the texture size when width/height are 0
+    void getTileSize(float& w, float& h) const;
+
+    // True when the layer is opaque and its tiles cover the whole screen
+    bool coversScreen(const View& view) const;
+
+    // Queue the tile copies visible from the current camera position
+    void submit(const View& view, RenderQueue& queue) const;
+};
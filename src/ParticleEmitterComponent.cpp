@@ -0,0 +1,30 @@
+#include "ParticleEmitterComponent.h"
+#include "Engine.h"
+#include "BodyComponent.h"
+
+ParticleEmitterComponent::ParticleEmitterComponent(const std::string& emitterName, float offsetX, float offsetY)
+    : emitterName(emitterName), offsetX(offsetX), offsetY(offsetY)
+{
+}
+
+ParticleEmitterComponent::~ParticleEmitterComponent() {
+    if (emitter != INVALID_EMITTER && Engine::E) {
+        Engine::E->getParticles().stop(emitter);
+    }
+}
+
+void ParticleEmitterComponent::update(float /*dt*/) {
+    BodyComponent* body = getObject()->getComponent<BodyComponent>();
+    if (!body) return;
+
+    float x = body->getX() + offsetX;
+    float y = body->getY() + offsetY;
+    ParticleSystem& particles = Engine::E->getParticles();
+    if (!started) {
+        // Only tried once, so an unknown emitter name is reported once
+        started = true;
+        emitter = particles.start(emitterName, x, y);
+    } else {
+        particles.setPosition(emitter, x, y);
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "Component.h"
+#include <string>
+#include "ParticleSystem.h"
+
+/**
+ * ParticleEmitterComponent - Keeps a running particle emitter on its object
+ *
+ * Starts the named emitter on the first update and moves it with the body
+ * (plus an offset); the emitter is stopped when the component goes away and
+ * its remaining particles fade out on their own.
+ */
+class ParticleEmitterComponent : public Component {
+public:
+    ParticleEmitterComponent(const std::string& emitterName, float offsetX = 0.0f, float offsetY = 0.0f);
+    ~ParticleEmitterComponent() override;
+
+    void update(float dt) override;
+
+    const std::string& getEmitterName() const { return emitterName; }
+    float getOffsetX() const { return offsetX; }
+    float getOffsetY() const { return offsetY; }
+
+private:
+    std::string emitterName;
+    float offsetX;
+    float offsetY;
+    EmitterId emitter = INVALID_EMITTER;
+    bool started = false;
+};
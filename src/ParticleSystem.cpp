@@ -0,0 +1,358 @@
+#include "ParticleSystem.h"
+#include "tinyxml2.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PARTICLES_SSE2 1
+#endif
+
+using namespace tinyxml2;
+
+// Static member definitions
+std::unordered_map<std::string, ParticleEmitterDesc> ParticleSystem::descs;
+
+// Below this many particles per slice, threading costs more than it saves
+static const size_t MIN_PARTICLES_PER_SLICE = 8192;
+
+// "a b" attribute pairs; a single value is used for both
+static void readRange(const XMLElement* elem, const char* name, float& low, float& high) {
+    const char* text = elem->Attribute(name);
+    if (!text) return;
+    std::istringstream in(text);
+    in >> low;
+    if (!(in >> high)) high = low;
+}
+
+static void readColor(const XMLElement* elem, const char* name, SDL_Color& color) {
+    const char* text = elem->Attribute(name);
+    if (!text) return;
+    int r = color.r, g = color.g, b = color.b, a = color.a;
+    std::istringstream in(text);
+    in >> r >> g >> b >> a;
+    color = SDL_Color{Uint8(r), Uint8(g), Uint8(b), Uint8(a)};
+}
+
+bool ParticleSystem::loadFromXML(const std::string& xmlPath) {
+    XMLDocument doc;
+    if (doc.LoadFile(xmlPath.c_str()) != XML_SUCCESS) {
+        std::cerr << "ParticleSystem: Failed to load " << xmlPath << std::endl;
+        return false;
+    }
+
+    XMLElement* root = doc.FirstChildElement("Assets");
+    if (!root) {
+        std::cerr << "ParticleSystem: No <Assets> root element in " << xmlPath << std::endl;
+        return false;
+    }
+
+    for (XMLElement* elem = root->FirstChildElement("ParticleEmitter"); elem; elem = elem->NextSiblingElement("ParticleEmitter")) {
+        const char* name = elem->Attribute("name");
+        if (!name) {
+            std::cerr << "ParticleSystem: ParticleEmitter entry missing name attribute in " << xmlPath << std::endl;
+            continue;
+        }
+
+        ParticleEmitterDesc desc;
+        desc.name = name;
+        desc.rate = elem->FloatAttribute("rate", desc.rate);
+        desc.burst = elem->IntAttribute("burst", desc.burst);
+        desc.budget = std::max(elem->IntAttribute("budget", desc.budget), 1);
+        readRange(elem, "life", desc.lifeMin, desc.lifeMax);
+        readRange(elem, "speed", desc.speedMin, desc.speedMax);
+        readRange(elem, "size", desc.sizeStart, desc.sizeEnd);
+        desc.angle = elem->FloatAttribute("angle", desc.angle);
+        desc.spread = elem->FloatAttribute("spread", desc.spread);
+        desc.gravity = elem->FloatAttribute("gravity", desc.gravity);
+        readColor(elem, "colorStart", desc.colorStart);
+        readColor(elem, "colorEnd", desc.colorEnd);
+        desc.lifeMin = std::max(desc.lifeMin, 0.01f);
+        desc.lifeMax = std::max(desc.lifeMax, desc.lifeMin);
+
+        // Emitters hold pointers to descs, so a reload updates them in place
+        descs[name] = desc;
+    }
+
+    return true;
+}
+
+const ParticleEmitterDesc* ParticleSystem::findDesc(const std::string& name) {
+    auto it = descs.find(name);
+    return it != descs.end() ? &it->second : nullptr;
+}
+
+void ParticleSystem::setCapacity(size_t newCapacity) {
+    capacity = newCapacity;
+    count = 0;
+    posX.assign(capacity, 0.0f);
+    posY.assign(capacity, 0.0f);
+    velX.assign(capacity, 0.0f);
+    velY.assign(capacity, 0.0f);
+    accelY.assign(capacity, 0.0f);
+    life.assign(capacity, 0.0f);
+    invLifetime.assign(capacity, 0.0f);
+    owner.assign(capacity, INVALID_EMITTER);
+    for (Emitter& e : emitters) e.live = 0;
+}
+
+EmitterId ParticleSystem::allocateEmitter(const ParticleEmitterDesc* desc, float x, float y) {
+    // Reuse a slot whose emitter has stopped and whose particles are gone
+    size_t slot = emitters.size();
+    for (size_t i = 0; i < emitters.size(); ++i) {
+        if (!emitters[i].used) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot >= INVALID_EMITTER) return INVALID_EMITTER;
+    if (slot == emitters.size()) emitters.emplace_back();
+
+    Emitter& e = emitters[slot];
+    e = Emitter{};
+    e.desc = desc;
+    e.x = x;
+    e.y = y;
+    e.used = true;
+    return EmitterId(slot);
+}
+
+EmitterId ParticleSystem::start(const std::string& descName, float x, float y) {
+    const ParticleEmitterDesc* desc = findDesc(descName);
+    if (!desc) {
+        std::cerr << "ParticleSystem: Unknown emitter '" << descName << "'" << std::endl;
+        return INVALID_EMITTER;
+    }
+    EmitterId id = allocateEmitter(desc, x, y);
+    if (id != INVALID_EMITTER) emitters[id].running = true;
+    return id;
+}
+
+void ParticleSystem::setPosition(EmitterId id, float x, float y) {
+    if (id >= emitters.size()) return;
+    emitters[id].x = x;
+    emitters[id].y = y;
+}
+
+void ParticleSystem::stop(EmitterId id) {
+    if (id >= emitters.size()) return;
+    emitters[id].running = false;
+    if (emitters[id].live == 0) emitters[id].used = false;
+}
+
+void ParticleSystem::burst(const std::string& descName, float x, float y, int n) {
+    const ParticleEmitterDesc* desc = findDesc(descName);
+    if (!desc) return;
+
+    // A one-shot emitter: not running, freed when its particles die
+    EmitterId id = allocateEmitter(desc, x, y);
+    if (id == INVALID_EMITTER) return;
+    spawn(id, n < 0 ? desc->burst : n);
+    if (emitters[id].live == 0) emitters[id].used = false;
+}
+
+float ParticleSystem::random01() {
+    // xorshift32: cheap and good enough for effects
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return float(rng >> 8) * (1.0f / 16777216.0f);
+}
+
+void ParticleSystem::spawn(EmitterId id, int n) {
+    Emitter& e = emitters[id];
+    const ParticleEmitterDesc& d = *e.desc;
+
+    // Per-emitter and global budgets
+    n = std::min(n, d.budget - e.live);
+    n = std::min<int>(n, int(capacity - count));
+    if (n <= 0) return;
+
+    const float degToRad = 3.14159265f / 180.0f;
+    for (int k = 0; k < n; ++k) {
+        size_t i = count++;
+        float angle = (d.angle + (random01() - 0.5f) * d.spread) * degToRad;
+        float speed = d.speedMin + (d.speedMax - d.speedMin) * random01();
+        float lifetime = d.lifeMin + (d.lifeMax - d.lifeMin) * random01();
+
+        posX[i] = e.x;
+        posY[i] = e.y;
+        velX[i] = std::cos(angle) * speed;
+        velY[i] = std::sin(angle) * speed;
+        accelY[i] = d.gravity;
+        life[i] = lifetime;
+        invLifetime[i] = 1.0f / lifetime;
+        owner[i] = id;
+    }
+    e.live += n;
+}
+
+void ParticleSystem::simulate(size_t begin, size_t end, float dt) {
+    float* px = posX.data();
+    float* py = posY.data();
+    float* vx = velX.data();
+    float* vy = velY.data();
+    const float* ay = accelY.data();
+    float* l = life.data();
+
+    size_t i = begin;
+#ifdef PARTICLES_SSE2
+    const __m128 step = _mm_set1_ps(dt);
+    for (; i + 4 <= end; i += 4) {
+        __m128 vyi = _mm_add_ps(_mm_loadu_ps(vy + i), _mm_mul_ps(_mm_loadu_ps(ay + i), step));
+        _mm_storeu_ps(vy + i, vyi);
+        _mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(_mm_loadu_ps(vx + i), step)));
+        _mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(vyi, step)));
+        _mm_storeu_ps(l + i, _mm_sub_ps(_mm_loadu_ps(l + i), step));
+    }
+#endif
+    // Remainder (or everything, without SSE2); plain loops the compiler can vectorise too
+    for (; i < end; ++i) {
+        vy[i] += ay[i] * dt;
+        px[i] += vx[i] * dt;
+        py[i] += vy[i] * dt;
+        l[i] -= dt;
+    }
+}
+
+void ParticleSystem::removeDead() {
+    size_t i = 0;
+    while (i < count) {
+        if (life[i] > 0.0f) {
+            ++i;
+            continue;
+        }
+
+        Emitter& e = emitters[owner[i]];
+        if (--e.live == 0 && !e.running) e.used = false;
+
+        // Swap the last live particle into the hole
+        size_t last = --count;
+        posX[i] = posX[last];
+        posY[i] = posY[last];
+        velX[i] = velX[last];
+        velY[i] = velY[last];
+        accelY[i] = accelY[last];
+        life[i] = life[last];
+        invLifetime[i] = invLifetime[last];
+        owner[i] = owner[last];
+    }
+}
+
+void ParticleSystem::update(float dt) {
+    // Running emitters spawn at their rate
+    for (size_t id = 0; id < emitters.size(); ++id) {
+        Emitter& e = emitters[id];
+        if (!e.used || !e.running || e.desc->rate <= 0.0f) continue;
+        e.accumulator += e.desc->rate * dt;
+        int n = int(e.accumulator);
+        e.accumulator -= float(n);
+        if (n > 0) spawn(EmitterId(id), n);
+    }
+
+    if (count == 0) return;
+    workers.parallelFor(count, MIN_PARTICLES_PER_SLICE, [this, dt](size_t begin, size_t end) {
+        simulate(begin, end, dt);
+    });
+    removeDead();
+}
+
+void ParticleSystem::render(const View& view) {
+    std::vector<SDL_Vertex>& out = vertices[writeIndex];
+    if (out.size() < count * 4) out.resize(count * 4);
+
+    int written = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const ParticleEmitterDesc& d = *emitters[owner[i]].desc;
+
+        // Age fraction 0 (born) .. 1 (dead) drives size and colour
+        float t = 1.0f - life[i] * invLifetime[i];
+        float half = 0.5f * (d.sizeStart + (d.sizeEnd - d.sizeStart) * t) * view.scale;
+        float sx = (posX[i] - view.x) * view.scale;
+        float sy = (posY[i] - view.y) * view.scale;
+        if (sx + half < 0 || sy + half < 0 || sx - half > view.screenWidth || sy - half > view.screenHeight) continue;
+
+        SDL_Color c;
+        c.r = Uint8(d.colorStart.r + (d.colorEnd.r - d.colorStart.r) * t);
+        c.g = Uint8(d.colorStart.g + (d.colorEnd.g - d.colorStart.g) * t);
+        c.b = Uint8(d.colorStart.b + (d.colorEnd.b - d.colorStart.b) * t);
+        c.a = Uint8(d.colorStart.a + (d.colorEnd.a - d.colorStart.a) * t);
+
+        SDL_Vertex* v = &out[written];
+        v[0] = SDL_Vertex{{sx - half, sy - half}, c, {0.0f, 0.0f}};
+        v[1] = SDL_Vertex{{sx + half, sy - half}, c, {0.0f, 0.0f}};
+        v[2] = SDL_Vertex{{sx + half, sy + half}, c, {0.0f, 0.0f}};
+        v[3] = SDL_Vertex{{sx - half, sy + half}, c, {0.0f, 0.0f}};
+        written += 4;
+    }
+    vertexCount[writeIndex] = written;
+}
+
+void ParticleSystem::swapBuffers() {
+    writeIndex ^= 1;
+    vertexCount[writeIndex] = 0;
+}
+
+void ParticleSystem::flush() {
+    int drawIndex = writeIndex ^ 1;
+    int quads = vertexCount[drawIndex] / 4;
+    if (!renderer || quads == 0) return;
+
+    // Same two triangles for every quad
+    size_t needed = size_t(quads) * 6;
+    if (indices.size() < needed) {
+        size_t first = indices.size() / 6;
+        indices.resize(needed);
+        for (size_t q = first; q < size_t(quads); ++q) {
+            int base = int(q * 4);
+            int* idx = &indices[q * 6];
+            idx[0] = base;
+            idx[1] = base + 1;
+            idx[2] = base + 2;
+            idx[3] = base;
+            idx[4] = base + 2;
+            idx[5] = base + 3;
+        }
+    }
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_RenderGeometry(renderer, nullptr, vertices[drawIndex].data(), vertexCount[drawIndex],
+                       indices.data(), quads * 6);
+}
+
+void ParticleSystem::clear() {
+    count = 0;
+    emitters.clear();
+    vertexCount[writeIndex] = 0;
+}
+
+void ParticleSystem::countStats(RenderStats& stats) const {
+    int drawIndex = writeIndex ^ 1;
+    int quads = vertexCount[drawIndex] / 4;
+    if (quads == 0) return;
+
+    // Quads are axis aligned: corners 0 and 2 span them
+    uint64_t pixels = 0;
+    const SDL_Vertex* v = vertices[drawIndex].data();
+    for (int q = 0; q < quads; ++q, v += 4) {
+        pixels += uint64_t((v[2].position.x - v[0].position.x) * (v[2].position.y - v[0].position.y));
+    }
+    stats.addPixels(StatCategory::Particles, uint32_t(quads), pixels);
+    stats.countDrawCall(StatCategory::Particles);
+}
+
+void ParticleSystem::drawCoverage(SpriteBatch& batch, SDL_Texture* white, SDL_Color step) const {
+    int drawIndex = writeIndex ^ 1;
+    int quads = vertexCount[drawIndex] / 4;
+    if (!white) return;
+
+    const SDL_Vertex* v = vertices[drawIndex].data();
+    for (int q = 0; q < quads; ++q, v += 4) {
+        SDL_FRect dst = {v[0].position.x, v[0].position.y,
+                         v[2].position.x - v[0].position.x, v[2].position.y - v[0].position.y};
+        batch.draw(white, nullptr, dst, 0.0f, SDL_FLIP_NONE, step, SDL_BLENDMODE_ADD);
+    }
+    batch.flush();
+}
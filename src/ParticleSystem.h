@@ -0,0 +1,140 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "View.h"
+#include "RenderStats.h"
+#include "SpriteBatch.h"
+#include "WorkerPool.h"
+
+using EmitterId = uint16_t;
+static constexpr EmitterId INVALID_EMITTER = 0xFFFF;
+
+/**
+ * How an emitter spawns particles; shared by every emitter of that name
+ */
+struct ParticleEmitterDesc {
+    std::string name;
+    float rate = 0.0f;                // particles per second while running
+    int burst = 0;                    // particles spawned at once by burst()
+    int budget = 256;                 // live particles this emitter may own
+    float lifeMin = 0.5f, lifeMax = 1.0f;
+    float speedMin = 20.0f, speedMax = 60.0f;
+    float angle = 270.0f;             // degrees, 0 = right, 90 = down (screen space)
+    float spread = 360.0f;            // degrees around angle
+    float gravity = 0.0f;             // downward acceleration, pixels/s^2
+    float sizeStart = 4.0f, sizeEnd = 1.0f;
+    SDL_Color colorStart{255, 255, 255, 255};
+    SDL_Color colorEnd{255, 255, 255, 0};
+};
+
+/**
+ * ParticleSystem - Cheap world-space effects (dust, sparks, trails)
+ *
+ * Particles are plain entries in structure-of-arrays storage sized once for
+ * the global budget: no Object, no Box2D body and no allocation per particle.
+ * The update kernel walks the arrays linearly (four at a time with SSE when
+ * available) and is split across a WorkerPool for large counts. Dead particles
+ * are removed by swapping in the last one.
+ *
+ * Drawing follows DebugDraw: render() writes untextured quads into one of two
+ * vertex buffers and flush() submits the other with a single
+ * SDL_RenderGeometry call, so the render thread can draw the previous frame.
+ */
+class ParticleSystem {
+public:
+    ParticleSystem() = default;
+
+    void setRenderer(SDL_Renderer* renderer) { this->renderer = renderer; }
+
+    // Global budget; drops every live particle
+    void setCapacity(size_t capacity);
+    size_t getCapacity() const { return capacity; }
+
+    // Worker threads used by update() for large particle counts
+    void setWorkerCount(unsigned count) { workers.setWorkerCount(count); }
+
+    /**
+     * Load <ParticleEmitter> entries from an XML file
+     *
+     * <ParticleEmitter name="dust" burst="12" budget="64" life="0.3 0.6" speed="20 60"
+     *                  angle="270" spread="120" gravity="200" size="4 1"
+     *                  colorStart="200 180 140 255" colorEnd="200 180 140 0" />
+     */
+    static bool loadFromXML(const std::string& xmlPath);
+    static const ParticleEmitterDesc* findDesc(const std::string& name);
+
+    /**
+     * Start an emitter at a world position (SDL coordinates)
+     * @return id to move or stop it, INVALID_EMITTER if unknown or out of slots
+     */
+    EmitterId start(const std::string& descName, float x, float y);
+    void setPosition(EmitterId id, float x, float y);
+    // Stop spawning; the slot is reused once its particles have died
+    void stop(EmitterId id);
+
+    // One-off burst (desc->burst particles, or count if given)
+    void burst(const std::string& descName, float x, float y, int count = -1);
+
+    // Advance emitters and particles
+    void update(float dt);
+
+    // Write this frame's quads (simulation thread)
+    void render(const View& view);
+
+    // Make the quads written by render() the ones flush() draws
+    void swapBuffers();
+
+    // Draw the swapped-in quads (render thread)
+    void flush();
+
+    // Report the swapped-in quads to the frame's stats, or add them to the overdraw heatmap
+    void countStats(RenderStats& stats) const;
+    void drawCoverage(SpriteBatch& batch, SDL_Texture* white, SDL_Color step) const;
+
+    // Drop every particle and emitter (level changes)
+    void clear();
+
+    size_t getCount() const { return count; }
+
+private:
+    struct Emitter {
+        const ParticleEmitterDesc* desc = nullptr;
+        float x = 0.0f, y = 0.0f;
+        float accumulator = 0.0f; // fractional particles owed by rate
+        int live = 0;             // particles owned right now
+        bool running = false;
+        bool used = false;
+    };
+
+    EmitterId allocateEmitter(const ParticleEmitterDesc* desc, float x, float y);
+    void spawn(EmitterId owner, int n);
+    void simulate(size_t begin, size_t end, float dt);
+    void removeDead();
+    float random01();
+
+    static std::unordered_map<std::string, ParticleEmitterDesc> descs;
+
+    // Structure of arrays, all sized to capacity; [0, count) are alive
+    std::vector<float> posX, posY;
+    std::vector<float> velX, velY;
+    std::vector<float> accelY;
+    std::vector<float> life;         // seconds left
+    std::vector<float> invLifetime;  // 1 / total lifetime, for the age fraction
+    std::vector<EmitterId> owner;
+    size_t count = 0;
+    size_t capacity = 0;
+
+    std::vector<Emitter> emitters; // indexed by EmitterId
+    WorkerPool workers;
+    uint32_t rng = 0x9E3779B9u;
+
+    // Double-buffered quads: written by render(), drawn by flush()
+    SDL_Renderer* renderer = nullptr;
+    std::vector<SDL_Vertex> vertices[2];
+    std::vector<int> indices;  // shared quad index pattern, grown as needed
+    int vertexCount[2] = {0, 0};
+    int writeIndex = 0;
+};
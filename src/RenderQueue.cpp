@@ -0,0 +1,181 @@
+#include "RenderQueue.h"
+#include "SpriteBatch.h"
+#include "RenderStats.h"
+#include <algorithm>
+
+std::unordered_map<SDL_Texture*, uint16_t> RenderQueue::textureIds;
+std::vector<uint16_t> RenderQueue::freeTextureIds;
+uint32_t RenderQueue::nextTextureId = 0;
+
+uint16_t RenderQueue::depthFromParallax(float factor) {
+    // Factor 1.0 lines up with the default world depth
+    float depth = factor * DEFAULT_WORLD_DEPTH;
+    if (depth < 0.0f) depth = 0.0f;
+    if (depth > 65535.0f) depth = 65535.0f;
+    return uint16_t(depth);
+}
+
+uint64_t RenderQueue::makeKey(RenderLayer layer, uint16_t depth, uint16_t textureId, float ySort) {
+    // Bias y so negative positions still sort correctly, then clamp to 24 bits
+    int64_t y = int64_t(ySort) + (int64_t(1) << 23);
+    if (y < 0) y = 0;
+    if (y > 0xFFFFFF) y = 0xFFFFFF;
+
+    return (uint64_t(layer) << 56)
+         | (uint64_t(depth) << 40)
+         | (uint64_t(textureId) << 24)
+         | uint64_t(y);
+}
+
+uint16_t RenderQueue::getTextureId(SDL_Texture* texture) {
+    auto it = textureIds.find(texture);
+    if (it != textureIds.end()) return it->second;
+
+    // Out of ids: the rest share the last one (still drawn correctly, just grouped less well)
+    uint16_t id = OVERFLOW_TEXTURE_ID;
+    if (!freeTextureIds.empty()) {
+        id = freeTextureIds.back();
+        freeTextureIds.pop_back();
+    } else if (nextTextureId < OVERFLOW_TEXTURE_ID) {
+        id = uint16_t(nextTextureId++);
+    } else {
+        return id;
+    }
+    textureIds[texture] = id;
+    return id;
+}
+
+void RenderQueue::forgetTexture(SDL_Texture* texture) {
+    auto it = textureIds.find(texture);
+    if (it == textureIds.end()) return;
+    freeTextureIds.push_back(it->second);
+    textureIds.erase(it);
+}
+
+void RenderQueue::submit(RenderLayer layer, uint16_t depth, float ySort,
+                         SDL_Texture* texture, const SDL_Rect* src, const SDL_FRect& dst,
+                         float angle, SDL_RendererFlip flip, SDL_Color color, SDL_BlendMode blend) {
+    if (!texture) return;
+
+    RenderCommand cmd;
+    cmd.texture = texture;
+    if (src) {
+        cmd.src = *src;
+        cmd.hasSrc = true;
+    }
+    cmd.dst = dst;
+    cmd.angle = angle;
+    cmd.flip = flip;
+    cmd.color = color;
+    cmd.blend = blend;
+
+    commands.push_back(cmd);
+    keys.push_back(makeKey(layer, depth, getTextureId(texture), ySort));
+    sorted = false;
+}
+
+void RenderQueue::sort() {
+    const size_t n = keys.size();
+    order.resize(n);
+    orderScratch.resize(n);
+    keyScratch.resize(n);
+    for (size_t i = 0; i < n; ++i) order[i] = uint32_t(i);
+
+    // LSD radix sort, 8 bits per pass; sorts a copy of the keys together with the indices
+    sortKeys.assign(keys.begin(), keys.end());
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t counts[256] = {0};
+        for (size_t i = 0; i < n; ++i) {
+            ++counts[(sortKeys[i] >> shift) & 0xFF];
+        }
+
+        // All keys share this digit: the pass would not change anything
+        if (counts[(sortKeys[0] >> shift) & 0xFF] == n) continue;
+
+        size_t offset = 0;
+        for (size_t& c : counts) {
+            size_t count = c;
+            c = offset;
+            offset += count;
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            size_t dest = counts[(sortKeys[i] >> shift) & 0xFF]++;
+            keyScratch[dest] = sortKeys[i];
+            orderScratch[dest] = order[i];
+        }
+        sortKeys.swap(keyScratch);
+        order.swap(orderScratch);
+    }
+
+    sorted = true;
+}
+
+void RenderQueue::dispatch(SpriteBatch& batch, RenderLayer first, RenderLayer last) {
+    if (commands.empty()) return;
+    if (!sorted) sort();
+
+    RenderStats* stats = batch.getStats();
+    bool counting = stats && stats->isCounting();
+
+    for (uint32_t index : order) {
+        RenderLayer layer = RenderLayer(keys[index] >> 56);
+        if (layer < first) continue;
+        if (layer > last) break; // order is sorted by layer first
+
+        if (counting) stats->setCategory(StatCategory(layer));
+        const RenderCommand& cmd = commands[index];
+        batch.draw(cmd.texture, cmd.hasSrc ? &cmd.src : nullptr, cmd.dst,
+                   cmd.angle, cmd.flip, cmd.color, cmd.blend);
+    }
+    batch.flush();
+}
+
+void RenderQueue::dispatchCoverage(SpriteBatch& batch, RenderLayer first, RenderLayer last,
+                                   SDL_Texture* white, SDL_Color step) {
+    if (commands.empty() || !white) return;
+    if (!sorted) sort();
+
+    for (uint32_t index : order) {
+        RenderLayer layer = RenderLayer(keys[index] >> 56);
+        if (layer < first) continue;
+        if (layer > last) break;
+
+        const RenderCommand& cmd = commands[index];
+        batch.draw(white, nullptr, cmd.dst, cmd.angle, SDL_FLIP_NONE, step, SDL_BLENDMODE_ADD);
+    }
+    batch.flush();
+}
+
+uint64_t RenderQueue::signature() const {
+    // FNV-1a over the fields (not the raw structs, whose padding is undefined)
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    };
+
+    for (size_t i = 0; i < commands.size(); ++i) {
+        const RenderCommand& cmd = commands[i];
+        mix(&keys[i], sizeof(keys[i]));
+        mix(&cmd.texture, sizeof(cmd.texture));
+        if (cmd.hasSrc) mix(&cmd.src, sizeof(cmd.src));
+        mix(&cmd.dst, sizeof(cmd.dst));
+        mix(&cmd.angle, sizeof(cmd.angle));
+        mix(&cmd.flip, sizeof(cmd.flip));
+        mix(&cmd.color, sizeof(cmd.color));
+        mix(&cmd.blend, sizeof(cmd.blend));
+    }
+    return hash;
+}
+
+void RenderQueue::clear() {
+    commands.clear();
+    keys.clear();
+    order.clear();
+    sorted = false;
+    for (uint32_t& c : culled) c = 0;
+}
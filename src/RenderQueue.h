@@ -0,0 +1,111 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class SpriteBatch;
+
+// Coarse draw order; higher layers are drawn on top
+enum class RenderLayer : uint8_t {
+    Background = 0, // parallax layers
+    World = 1,      // level sprites and animations
+    Foreground = 2, // world-space effects drawn over sprites
+    HUD = 3         // screen-space UI
+};
+
+/**
+ * A single textured quad waiting to be drawn
+ */
+struct RenderCommand {
+    SDL_Texture* texture = nullptr;
+    SDL_Rect src{0, 0, 0, 0};
+    bool hasSrc = false;
+    SDL_FRect dst{0, 0, 0, 0};
+    float angle = 0.0f;
+    SDL_RendererFlip flip = SDL_FLIP_NONE;
+    SDL_Color color{255, 255, 255, 255};
+    SDL_BlendMode blend = SDL_BLENDMODE_BLEND;
+};
+
+/**
+ * RenderQueue - Collects render commands for a frame and draws them in sorted order
+ *
+ * Every command carries a packed 64-bit sort key:
+ *   [63..56] layer  [55..40] depth  [39..24] texture id  [23..0] y-sort
+ * Keys are radix sorted (stable, so equal keys keep submission order) and the
+ * commands are then dispatched into a SpriteBatch. Grouping by texture inside a
+ * depth keeps texture switches, and therefore batch flushes, to a minimum.
+ */
+class RenderQueue {
+public:
+    // Depth used by world sprites unless they ask for something else
+    static constexpr uint16_t DEFAULT_WORLD_DEPTH = 1000;
+
+    // Map a parallax factor (0 = far sky, 1 = moves with camera) to a depth
+    static uint16_t depthFromParallax(float factor);
+
+    static uint64_t makeKey(RenderLayer layer, uint16_t depth, uint16_t textureId, float ySort);
+
+    /**
+     * Queue a quad
+     * @param ySort Sort value inside a depth/texture group, usually the bottom edge of dst
+     */
+    void submit(RenderLayer layer, uint16_t depth, float ySort,
+                SDL_Texture* texture, const SDL_Rect* src, const SDL_FRect& dst,
+                float angle = 0.0f, SDL_RendererFlip flip = SDL_FLIP_NONE,
+                SDL_Color color = {255, 255, 255, 255},
+                SDL_BlendMode blend = SDL_BLENDMODE_BLEND);
+
+    // Sort (once) and draw every queued command whose layer is in [first, last]
+    void dispatch(SpriteBatch& batch, RenderLayer first, RenderLayer last);
+
+    /**
+     * Overdraw heatmap pass: every command in [first, last] drawn as its rectangle
+     * with the white texture, additively, in the step colour
+     */
+    void dispatchCoverage(SpriteBatch& batch, RenderLayer first, RenderLayer last,
+                          SDL_Texture* white, SDL_Color step);
+
+    // Hash of everything queued, to tell whether a frame differs from the previous one
+    uint64_t signature() const;
+
+    // Objects skipped by culling before they were queued (reported with the frame's stats)
+    void countCulled(RenderLayer layer, uint32_t count = 1) { culled[size_t(layer)] += count; }
+    uint32_t getCulled(RenderLayer layer) const { return culled[size_t(layer)]; }
+
+    // Drop all queued commands (call once per frame after dispatching)
+    void clear();
+
+    /**
+     * Give up the sort id of a texture that is about to be destroyed
+     *
+     * Ids are shared by every queue, so a texture sorts the same way whichever
+     * queue it lands in. Call from the thread that submits, before the texture
+     * is destroyed, so its id can go to a new texture instead of piling up.
+     */
+    static void forgetTexture(SDL_Texture* texture);
+
+    size_t size() const { return commands.size(); }
+
+private:
+    static uint16_t getTextureId(SDL_Texture* texture);
+    void sort();
+
+    std::vector<RenderCommand> commands;
+    std::vector<uint64_t> keys;
+
+    // Sorted order of commands (indices), plus scratch buffers for the radix passes
+    std::vector<uint32_t> order;
+    std::vector<uint32_t> orderScratch;
+    std::vector<uint64_t> sortKeys;
+    std::vector<uint64_t> keyScratch;
+    bool sorted = false;
+    uint32_t culled[4] = {0, 0, 0, 0}; // by RenderLayer
+
+    // Small stable ids for the texture field of the key, shared by every queue
+    static std::unordered_map<SDL_Texture*, uint16_t> textureIds;
+    static std::vector<uint16_t> freeTextureIds; // given up by forgetTexture()
+    static uint32_t nextTextureId;
+    static constexpr uint16_t OVERFLOW_TEXTURE_ID = 0xFFFF; // shared once every id is taken
+};
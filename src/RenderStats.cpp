@@ -0,0 +1,153 @@
+#include "RenderStats.h"
+#include "ImageDevice.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+CategoryStats RenderFrameStats::total() const {
+    CategoryStats sum;
+    for (const CategoryStats& c : categories) {
+        sum.quads += c.quads;
+        sum.drawCalls += c.drawCalls;
+        sum.textureSwitches += c.textureSwitches;
+        sum.culled += c.culled;
+        sum.pixels += c.pixels;
+    }
+    return sum;
+}
+
+double RenderFrameStats::overdraw() const {
+    return screenPixels > 0 ? double(total().pixels) / double(screenPixels) : 0.0;
+}
+
+const char* RenderStats::categoryName(StatCategory category) {
+    switch (category) {
+        case StatCategory::Background: return "background";
+        case StatCategory::World: return "world";
+        case StatCategory::Foreground: return "foreground";
+        case StatCategory::HUD: return "hud";
+        case StatCategory::Particles: return "particles";
+        case StatCategory::Composite: return "composite";
+        default: return "?";
+    }
+}
+
+void RenderStats::beginFrame(int width, int height) {
+    counting = enabled;
+    if (!counting) return;
+
+    frame = RenderFrameStats();
+    texturePixels.clear();
+    outputW = width;
+    outputH = height;
+    frame.screenPixels = uint64_t(std::max(width, 0)) * uint64_t(std::max(height, 0));
+    current = StatCategory::World;
+    pixelScale = 1.0f;
+}
+
+void RenderStats::countQuad(SDL_Texture* texture, const SDL_FRect& dst) {
+    // Covered area clipped to the screen; rotation is ignored
+    float x0 = std::max(dst.x, 0.0f);
+    float y0 = std::max(dst.y, 0.0f);
+    float x1 = std::min(dst.x + dst.w, float(outputW));
+    float y1 = std::min(dst.y + dst.h, float(outputH));
+    uint64_t pixels = 0;
+    if (x1 > x0 && y1 > y0) {
+        pixels = uint64_t((x1 - x0) * (y1 - y0) * pixelScale * pixelScale);
+    }
+
+    CategoryStats& c = frame.categories[size_t(current)];
+    ++c.quads;
+    c.pixels += pixels;
+    texturePixels[texture] += pixels;
+}
+
+void RenderStats::addPixels(StatCategory category, uint32_t quads, uint64_t pixels) {
+    CategoryStats& c = frame.categories[size_t(category)];
+    c.quads += quads;
+    c.pixels += pixels;
+}
+
+void RenderStats::endFrame() {
+    if (!counting) return;
+    counting = false;
+
+    // Keep only the textures that cost the most
+    frame.topTextures.assign(texturePixels.begin(), texturePixels.end());
+    size_t keep = std::min(frame.topTextures.size(), TOP_TEXTURES);
+    std::partial_sort(frame.topTextures.begin(), frame.topTextures.begin() + keep, frame.topTextures.end(),
+                      [](const auto& a, const auto& b) { return a.second > b.second; });
+    frame.topTextures.resize(keep);
+
+    std::lock_guard<std::mutex> lock(publishMutex);
+    published = frame;
+}
+
+RenderFrameStats RenderStats::getLastFrame() const {
+    std::lock_guard<std::mutex> lock(publishMutex);
+    return published;
+}
+
+void RenderStats::print(std::ostream& out) const {
+    RenderFrameStats stats = getLastFrame();
+    if (stats.screenPixels == 0) {
+        out << "RenderStats: No frame recorded yet" << std::endl;
+        return;
+    }
+
+    out << "RenderStats: " << std::setw(11) << "category" << std::setw(8) << "quads" << std::setw(7) << "calls"
+        << std::setw(9) << "switches" << std::setw(8) << "culled" << std::setw(11) << "pixels"
+        << std::setw(8) << "screens" << std::endl;
+    auto row = [&](const char* name, const CategoryStats& c) {
+        out << "RenderStats: " << std::setw(11) << name << std::setw(8) << c.quads << std::setw(7) << c.drawCalls
+            << std::setw(9) << c.textureSwitches << std::setw(8) << c.culled << std::setw(11) << c.pixels
+            << std::setw(8) << std::fixed << std::setprecision(2) << double(c.pixels) / double(stats.screenPixels)
+            << std::defaultfloat << std::endl;
+    };
+    for (size_t i = 0; i < size_t(StatCategory::Count); ++i) {
+        row(categoryName(StatCategory(i)), stats.categories[i]);
+    }
+    row("total", stats.total());
+
+    for (const auto& entry : stats.topTextures) {
+        const std::string& name = ImageDevice::nameOf(entry.first);
+        out << "RenderStats:   " << (name.empty() ? "(unnamed)" : name) << ": " << entry.second << " px" << std::endl;
+    }
+}
+
+bool RenderStats::beginHeatmap() {
+    int w = 0, h = 0;
+    if (!renderer || SDL_GetRendererOutputSize(renderer, &w, &h) != 0 || !SDL_RenderTargetSupported(renderer)) {
+        return false;
+    }
+
+    if (!heatmapTarget || heatmapW != w || heatmapH != h) {
+        clear();
+        heatmapTarget = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, w, h);
+        if (!heatmapTarget) {
+            std::cerr << "RenderStats: Failed to create heatmap target: " << SDL_GetError() << std::endl;
+            heatmap = false;
+            return false;
+        }
+        SDL_SetTextureBlendMode(heatmapTarget, SDL_BLENDMODE_NONE);
+        heatmapW = w;
+        heatmapH = h;
+    }
+
+    SDL_SetRenderTarget(renderer, heatmapTarget);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    return true;
+}
+
+void RenderStats::endHeatmap() {
+    SDL_SetRenderTarget(renderer, nullptr);
+    SDL_RenderCopy(renderer, heatmapTarget, nullptr, nullptr);
+}
+
+void RenderStats::clear() {
+    if (heatmapTarget) SDL_DestroyTexture(heatmapTarget);
+    heatmapTarget = nullptr;
+    heatmapW = heatmapH = 0;
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include <SDL.h>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// What a draw is counted under; the first four match RenderLayer
+enum class StatCategory : uint8_t {
+    Background = 0,
+    World = 1,
+    Foreground = 2,
+    HUD = 3,
+    Particles = 4,
+    Composite = 5, // upscaling the world pass to the window
+    Count
+};
+
+struct CategoryStats {
+    uint32_t quads = 0;
+    uint32_t drawCalls = 0;
+    uint32_t textureSwitches = 0;
+    uint32_t culled = 0;   // objects skipped before they were queued
+    uint64_t pixels = 0;   // pixels covered, clipped to the screen (at the internal resolution for world layers)
+};
+
+/**
+ * Counters of one drawn frame
+ */
+struct RenderFrameStats {
+    CategoryStats categories[size_t(StatCategory::Count)];
+    std::vector<std::pair<SDL_Texture*, uint64_t>> topTextures; // most pixels first
+    uint64_t screenPixels = 0;
+
+    const CategoryStats& operator[](StatCategory c) const { return categories[size_t(c)]; }
+    CategoryStats total() const;
+    // Average number of times each screen pixel was written
+    double overdraw() const;
+};
+
+/**
+ * RenderStats - Per-frame renderer instrumentation
+ *
+ * Every textured draw in the engine (sprites, animations, text, HUD, menus,
+ * drawImage/drawRect) ends up in RenderQueue::dispatch and SpriteBatch, which
+ * report quads, covered pixels, texture switches and draw calls here under the
+ * category being dispatched. Particles and the resolution upscale report
+ * themselves; objects culled before queueing travel with the RenderQueue.
+ *
+ * Counting happens where the frame is drawn (the render thread when there is
+ * one); the finished frame is published under a lock for getLastFrame().
+ *
+ * The overdraw heatmap replaces the frame with an offscreen target into which
+ * every quad's rectangle is added with SDL_BLENDMODE_ADD and a fixed step
+ * colour, so areas drawn once are dark red and heavily overdrawn areas run
+ * through orange and yellow to white.
+ */
+class RenderStats {
+public:
+    static constexpr size_t TOP_TEXTURES = 8;
+    static constexpr SDL_Color HEAT_STEP = {32, 16, 8, 255}; // saturates after 8 / 16 / 32 layers
+
+    static const char* categoryName(StatCategory category);
+
+    RenderStats() = default;
+
+    RenderStats(const RenderStats&) = delete;
+    RenderStats& operator=(const RenderStats&) = delete;
+
+    void setRenderer(SDL_Renderer* renderer) { this->renderer = renderer; }
+
+    void setEnabled(bool value) { enabled = value; }
+    bool isEnabled() const { return enabled; }
+
+    void setHeatmapEnabled(bool value) { heatmap = value; }
+    bool isHeatmapEnabled() const { return heatmap; }
+
+    // Frame boundaries (where the frame is drawn); counting only happens in between
+    void beginFrame(int outputWidth, int outputHeight);
+    void endFrame();
+    bool isCounting() const { return counting; }
+
+    // Category the following draws are counted under
+    void setCategory(StatCategory category) { current = category; }
+    StatCategory getCategory() const { return current; }
+
+    // Scale of the pass being drawn (resolution scaling makes world pixels cheaper)
+    void setPixelScale(float scale) { pixelScale = scale; }
+
+    void countQuad(SDL_Texture* texture, const SDL_FRect& dst);
+    void countTextureSwitch() { ++frame.categories[size_t(current)].textureSwitches; }
+    void countDrawCall(StatCategory category) { ++frame.categories[size_t(category)].drawCalls; }
+    void countCulled(StatCategory category, uint32_t count) { frame.categories[size_t(category)].culled += count; }
+    void addPixels(StatCategory category, uint32_t quads, uint64_t pixels);
+
+    // Last finished frame (any thread)
+    RenderFrameStats getLastFrame() const;
+
+    // Table of the last frame, texture names resolved through ImageDevice
+    void print(std::ostream& out) const;
+
+    // Bind and clear the heatmap target; false if it cannot be used
+    bool beginHeatmap();
+    // Copy the heatmap to the window
+    void endHeatmap();
+
+    // Destroy the heatmap target (call where the renderer lives)
+    void clear();
+
+private:
+    SDL_Renderer* renderer = nullptr;
+    std::atomic<bool> enabled{false};
+    std::atomic<bool> heatmap{false};
+    bool counting = false;
+
+    StatCategory current = StatCategory::World;
+    float pixelScale = 1.0f;
+    int outputW = 0;
+    int outputH = 0;
+    RenderFrameStats frame;
+    std::unordered_map<SDL_Texture*, uint64_t> texturePixels;
+
+    mutable std::mutex publishMutex;
+    RenderFrameStats published;
+
+    SDL_Texture* heatmapTarget = nullptr;
+    int heatmapW = 0;
+    int heatmapH = 0;
+};
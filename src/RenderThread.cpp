@@ -0,0 +1,87 @@
+#include "RenderThread.h"
+#include <iostream>
+
+RenderThread::~RenderThread() {
+    stop();
+}
+
+void RenderThread::start(std::function<void()> drawFrame) {
+    if (running) return;
+    this->drawFrame = std::move(drawFrame);
+    stopping = false;
+    frameReady = false;
+    frameBusy = false;
+    running = true;
+    thread = std::thread(&RenderThread::run, this);
+    std::cout << "RenderThread: Started" << std::endl;
+}
+
+void RenderThread::stop() {
+    if (!running) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+    running = false;
+    std::cout << "RenderThread: Stopped" << std::endl;
+}
+
+void RenderThread::invoke(const std::function<void()>& task) {
+    if (!running || isCurrentThread()) {
+        task();
+        return;
+    }
+
+    Task entry{&task, false};
+    std::unique_lock<std::mutex> lock(mutex);
+    tasks.push_back(&entry);
+    wake.notify_one();
+    finished.wait(lock, [&] { return entry.finished; });
+}
+
+void RenderThread::waitForFrame() {
+    if (!running || isCurrentThread()) return;
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return !frameBusy; });
+}
+
+void RenderThread::submitFrame() {
+    if (!running) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        frameReady = true;
+        frameBusy = true;
+    }
+    wake.notify_one();
+}
+
+void RenderThread::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || frameReady || !tasks.empty(); });
+
+        // Uploads and other renderer work first, so the frame sees their results
+        while (!tasks.empty()) {
+            Task* task = tasks.front();
+            tasks.pop_front();
+            lock.unlock();
+            (*task->function)();
+            lock.lock();
+            task->finished = true;
+            finished.notify_all();
+        }
+
+        if (frameReady) {
+            frameReady = false;
+            lock.unlock();
+            drawFrame();
+            lock.lock();
+            frameBusy = false;
+            finished.notify_all();
+        } else if (stopping) {
+            break;
+        }
+    }
+}
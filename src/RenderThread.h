@@ -0,0 +1,67 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * RenderThread - Dedicated thread that owns the SDL_Renderer
+ *
+ * The simulation thread builds frame N+1 while this thread draws frame N.
+ * Frames are handed over with waitForFrame() (the previous snapshot is no
+ * longer in use) followed by submitFrame(). Anything else that must touch the
+ * renderer (texture uploads, render-target updates, destruction) goes through
+ * invoke(), which runs the task here and waits for it. Tasks run before a
+ * frame that is submitted but not started, so anything that destroys what
+ * that frame may still draw has to waitForFrame() first.
+ *
+ * When the thread is not running invoke() runs the task inline and the frame
+ * calls return immediately, so callers only need to draw the frame themselves.
+ */
+class RenderThread {
+public:
+    RenderThread() = default;
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    // Start the thread; drawFrame is called on it once per submitted frame
+    void start(std::function<void()> drawFrame);
+
+    // Finish pending work and join the thread
+    void stop();
+
+    bool isRunning() const { return running; }
+    bool isCurrentThread() const { return running && std::this_thread::get_id() == thread.get_id(); }
+
+    // Run task on the render thread and block until it is done
+    void invoke(const std::function<void()>& task);
+
+    // Block until the last submitted frame has been drawn (returns at once on this thread)
+    void waitForFrame();
+
+    // Hand the current snapshot to the render thread (returns immediately)
+    void submitFrame();
+
+private:
+    struct Task {
+        const std::function<void()>* function;
+        bool finished;
+    };
+
+    void run();
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;     // render thread waits for frames and tasks
+    std::condition_variable finished; // callers wait for their frame or task
+
+    std::function<void()> drawFrame;
+    std::deque<Task*> tasks;
+    bool running = false;
+    bool stopping = false;
+    bool frameReady = false;   // submitted, not yet started
+    bool frameBusy = false;    // submitted, not yet finished
+};
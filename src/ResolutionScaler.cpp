@@ -0,0 +1,105 @@
+#include "ResolutionScaler.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+void ResolutionScaler::setBounds(float minValue, float maxValue) {
+    maxScale = std::min(std::max(maxValue, SCALE_STEP), 1.0f);
+    minScale = std::min(std::max(minValue, SCALE_STEP), maxScale);
+    scale.store(maxScale, std::memory_order_relaxed);
+    smoothedMs = 0.0;
+    framesSinceChange = 0;
+}
+
+void ResolutionScaler::clear() {
+    if (target) SDL_DestroyTexture(target);
+    target = nullptr;
+    targetW = targetH = 0;
+    active = false;
+}
+
+bool ResolutionScaler::ensureTarget(int outputW, int outputH) {
+    if (target && targetW == outputW && targetH == outputH) return true;
+    clear();
+
+    if (!SDL_RenderTargetSupported(renderer)) {
+        std::cout << "ResolutionScaler: Renderer has no render targets, drawing at native resolution" << std::endl;
+        unsupported = true;
+        return false;
+    }
+
+    // The renderer's preferred format keeps the upscale a plain copy
+    Uint32 format = SDL_PIXELFORMAT_ARGB8888;
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(renderer, &info) == 0 && info.num_texture_formats > 0) {
+        format = info.texture_formats[0];
+    }
+
+    // Sized for scale 1 so changing the scale never reallocates
+    target = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_TARGET, outputW, outputH);
+    if (!target) {
+        std::cerr << "ResolutionScaler: Failed to create world target: " << SDL_GetError() << std::endl;
+        unsupported = true;
+        return false;
+    }
+    SDL_SetTextureBlendMode(target, SDL_BLENDMODE_NONE);
+    SDL_SetTextureScaleMode(target, SDL_ScaleModeNearest);
+    targetW = outputW;
+    targetH = outputH;
+    return true;
+}
+
+void ResolutionScaler::beginWorld() {
+    active = false;
+    float s = getScale();
+    int outputW = 0, outputH = 0;
+    if (!renderer || s >= 1.0f || unsupported ||
+        SDL_GetRendererOutputSize(renderer, &outputW, &outputH) != 0 || !ensureTarget(outputW, outputH)) {
+        SDL_RenderClear(renderer);
+        return;
+    }
+
+    used.w = std::max(int(std::ceil(outputW * s)), 1);
+    used.h = std::max(int(std::ceil(outputH * s)), 1);
+
+    // Clear only the part that gets drawn and upscaled (a full clear would cost native fill)
+    SDL_SetRenderTarget(renderer, target);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    SDL_RenderFillRect(renderer, &used);
+
+    // Setting the target reset the scale; the window's is restored when it is unbound
+    SDL_RenderSetScale(renderer, s, s);
+    activeScale = s;
+    active = true;
+}
+
+void ResolutionScaler::endWorld() {
+    if (!active) return;
+    active = false;
+    SDL_SetRenderTarget(renderer, nullptr);
+    SDL_RenderCopy(renderer, target, &used, nullptr);
+}
+
+void ResolutionScaler::recordFrame(double drawMs) {
+    if (minScale >= maxScale || budgetMs <= 0.0) return;
+
+    smoothedMs = smoothedMs > 0.0 ? smoothedMs + (drawMs - smoothedMs) * 0.1 : drawMs;
+    if (++framesSinceChange < SETTLE_FRAMES) return;
+
+    float current = getScale();
+    float next = current;
+    if (smoothedMs > budgetMs) {
+        next = current * float(std::sqrt(budgetMs / smoothedMs));
+        next = std::floor(next / SCALE_STEP) * SCALE_STEP;
+    } else if (smoothedMs < budgetMs * 0.7) {
+        // Well under budget: one step up, the next measurement decides whether it stays
+        next = current + SCALE_STEP;
+    }
+    next = std::min(std::max(next, minScale), maxScale);
+
+    if (next != current) {
+        scale.store(next, std::memory_order_relaxed);
+        smoothedMs = 0.0;
+        framesSinceChange = 0;
+    }
+}
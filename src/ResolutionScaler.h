@@ -0,0 +1,68 @@
+#pragma once
+#include <SDL.h>
+#include <atomic>
+
+/**
+ * ResolutionScaler - Draws the world pass at an adaptive internal resolution
+ *
+ * beginWorld() binds an internal render target and sets the renderer scale so
+ * the world is drawn with its usual screen coordinates into scale * window
+ * pixels; endWorld() upscales that area to the window, and everything drawn
+ * afterwards (HUD, text) is at native resolution. At scale 1 the target is
+ * skipped and the world goes straight to the window.
+ *
+ * recordFrame() feeds the measured draw time. Once it has settled, the scale is
+ * lowered when the smoothed time is over budget (draw cost follows the pixel
+ * count, so by the square root of the overshoot) and raised one step at a time
+ * when there is clear headroom. All calls happen where the renderer lives;
+ * getScale() may be read from any thread.
+ */
+class ResolutionScaler {
+public:
+    static constexpr float SCALE_STEP = 1.0f / 16.0f; // scales are multiples of this
+    static constexpr int SETTLE_FRAMES = 20;          // frames measured after each change
+
+    ResolutionScaler() = default;
+
+    ResolutionScaler(const ResolutionScaler&) = delete;
+    ResolutionScaler& operator=(const ResolutionScaler&) = delete;
+
+    void setRenderer(SDL_Renderer* renderer) { this->renderer = renderer; }
+
+    // Bounds for the internal scale (min == max pins it)
+    void setBounds(float minScale, float maxScale);
+    // Draw time to stay under, in milliseconds
+    void setBudget(double ms) { budgetMs = ms; }
+
+    void beginWorld();
+    void endWorld();
+
+    // Draw time of the frame just finished, in milliseconds
+    void recordFrame(double drawMs);
+
+    float getScale() const { return scale.load(std::memory_order_relaxed); }
+    // Scale the world pass is being drawn at (1 outside beginWorld()/endWorld() or when bypassed)
+    float getActiveScale() const { return active ? activeScale : 1.0f; }
+
+    // Destroy the target texture (call where the renderer lives, before it goes)
+    void clear();
+
+private:
+    bool ensureTarget(int outputW, int outputH);
+
+    SDL_Renderer* renderer = nullptr;
+    SDL_Texture* target = nullptr;
+    int targetW = 0;
+    int targetH = 0;
+    SDL_Rect used{0, 0, 0, 0};  // part of the target drawn this frame
+    bool active = false;        // target bound between beginWorld() and endWorld()
+    float activeScale = 1.0f;
+    bool unsupported = false;   // renderer has no render targets
+
+    float minScale = 0.5f;
+    float maxScale = 1.0f;
+    std::atomic<float> scale{1.0f};
+    double budgetMs = 13.0;
+    double smoothedMs = 0.0;
+    int framesSinceChange = 0;
+};
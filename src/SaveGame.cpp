@@ -6,6 +6,8 @@
 #include "CharacterComponent.h"
 #include "GroundComponent.h"
 #include "AnimateComponent.h"
+#include "AnimatorComponent.h"
+#include "ParticleEmitterComponent.h"
 #include "MissileComponent.h"
 #include "tinyxml2.h"
 #include <iostream>
@@ -152,9 +154,30 @@ void SaveGame::saveGameObject(XMLElement* parent, Object* obj, const std::string
         XMLElement* animateElem = doc->NewElement("AnimateComponent");
         objElem->InsertEndChild(animateElem);
         
+        animateElem->SetAttribute("clip", animate->getClipName().c_str());
         animateElem->SetAttribute("image", animate->getTextureName().c_str());
+        animateElem->SetAttribute("rate", animate->getRate());
+        animateElem->SetAttribute("phase", animate->getPhase());
       
     }
+
+    // Save ParticleEmitterComponent
+    if (auto* emitter = obj->getComponent<ParticleEmitterComponent>()) {
+        XMLElement* emitterElem = doc->NewElement("ParticleEmitterComponent");
+        objElem->InsertEndChild(emitterElem);
+        emitterElem->SetAttribute("emitter", emitter->getEmitterName().c_str());
+        emitterElem->SetAttribute("offsetX", emitter->getOffsetX());
+        emitterElem->SetAttribute("offsetY", emitter->getOffsetY());
+    }
+
+    // Save AnimatorComponent
+    if (auto* animator = obj->getComponent<AnimatorComponent>()) {
+        if (AnimationStateMachine::isValid(animator->getMachine())) {
+            XMLElement* animatorElem = doc->NewElement("AnimatorComponent");
+            objElem->InsertEndChild(animatorElem);
+            animatorElem->SetAttribute("machine", AnimationStateMachine::get(animator->getMachine()).name.c_str());
+        }
+    }
 }
 
 bool SaveGame::load(const std::string& filename, Engine& engine) {
@@ -250,6 +273,9 @@ bool SaveGame::load(const std::string& filename, Engine& engine) {
         playerElem = playerElem->NextSiblingElement("GameObject");
     }
     
+    // Existing objects may have been moved, so cached static scenery is stale
+    engine.getStaticCache().invalidate();
+    
     std::cout << "Game loaded successfully from: " << filename << std::endl;
     return true;
 }
@@ -341,16 +367,41 @@ void SaveGame::loadGameObject(XMLElement* objElem, Engine& engine, std::unordere
     // Load AnimateComponent
     XMLElement* animateElem = objElem->FirstChildElement("AnimateComponent");
     if (animateElem) {
+        // Prefer the saved clip; older saves only know the image
+        ClipId clip = INVALID_CLIP;
+        if (const char* clipName = animateElem->Attribute("clip")) {
+            clip = AnimationLibrary::find(clipName);
+        }
         const char* image = animateElem->Attribute("image");
-        if (image) {
-            // Note: Frame count/time should come from level.xml or be saved
-            // For now, we'll use defaults
+        if (clip == INVALID_CLIP && image) {
+            clip = AnimationLibrary::find(image);
+            if (clip == INVALID_CLIP) clip = AnimationLibrary::fromSheet(image, 1, 0.1f);
+        }
+        if (clip != INVALID_CLIP) {
             AnimateComponent* animate = obj->getComponent<AnimateComponent>();
             if (!animate) {
-                animate = obj->addComponent<AnimateComponent>(image, 1, 0.1f);
+                animate = obj->addComponent<AnimateComponent>(clip);
             } else {
-                animate->setTexture(image);
+                animate->setClip(clip);
             }
+            animate->setRate(animateElem->FloatAttribute("rate", 1.0f));
+            animate->setPhase(animateElem->FloatAttribute("phase", 0.0f));
+        }
+    }
+
+    // Load ParticleEmitterComponent
+    XMLElement* emitterElem = objElem->FirstChildElement("ParticleEmitterComponent");
+    if (emitterElem && emitterElem->Attribute("emitter") && !obj->getComponent<ParticleEmitterComponent>()) {
+        obj->addComponent<ParticleEmitterComponent>(emitterElem->Attribute("emitter"),
+            emitterElem->FloatAttribute("offsetX", 0.0f), emitterElem->FloatAttribute("offsetY", 0.0f));
+    }
+
+    // Load AnimatorComponent
+    XMLElement* animatorElem = objElem->FirstChildElement("AnimatorComponent");
+    if (animatorElem && !obj->getComponent<AnimatorComponent>()) {
+        MachineId machine = AnimationStateMachine::find(animatorElem->Attribute("machine") ? animatorElem->Attribute("machine") : "");
+        if (machine != INVALID_MACHINE) {
+            obj->addComponent<AnimatorComponent>(machine);
         }
     }
 }
@@ -0,0 +1,98 @@
+#include "SpriteBatch.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+void SpriteBatch::draw(SDL_Texture* texture, const SDL_Rect* src, const SDL_FRect& dst,
+                       float angle, SDL_RendererFlip flip, SDL_Color color, SDL_BlendMode blend) {
+    if (!renderer || !texture) return;
+
+    bool counting = stats && stats->isCounting();
+    if (counting) stats->countQuad(texture, dst);
+
+    // A new texture or blend mode starts a new batch
+    if (texture != currentTexture || blend != currentBlend) {
+        flush();
+        if (counting && texture != currentTexture) stats->countTextureSwitch();
+        currentTexture = texture;
+        currentBlend = blend;
+        if (SDL_QueryTexture(texture, nullptr, nullptr, &textureWidth, &textureHeight) != 0) {
+            std::cerr << "SpriteBatch: Failed to query texture: " << SDL_GetError() << std::endl;
+            currentTexture = nullptr;
+            return;
+        }
+    }
+
+    if (counting && indices.empty()) batchCategory = stats->getCategory();
+
+    // Texture coordinates (normalised)
+    float u0 = 0.0f, v0 = 0.0f, u1 = 1.0f, v1 = 1.0f;
+    if (src) {
+        u0 = src->x / float(textureWidth);
+        v0 = src->y / float(textureHeight);
+        u1 = (src->x + src->w) / float(textureWidth);
+        v1 = (src->y + src->h) / float(textureHeight);
+    }
+    if (flip & SDL_FLIP_HORIZONTAL) std::swap(u0, u1);
+    if (flip & SDL_FLIP_VERTICAL) std::swap(v0, v1);
+
+    // Corners relative to the centre of dst, rotated like SDL_RenderCopyEx
+    float hw = dst.w * 0.5f;
+    float hh = dst.h * 0.5f;
+    float cx = dst.x + hw;
+    float cy = dst.y + hh;
+
+    float corners[4][2] = { {-hw, -hh}, {hw, -hh}, {hw, hh}, {-hw, hh} };
+    if (angle != 0.0f) {
+        float rad = angle * 3.14159265f / 180.0f;
+        float c = std::cos(rad);
+        float s = std::sin(rad);
+        for (auto& p : corners) {
+            float x = p[0];
+            float y = p[1];
+            p[0] = x * c - y * s;
+            p[1] = x * s + y * c;
+        }
+    }
+
+    const float uv[4][2] = { {u0, v0}, {u1, v0}, {u1, v1}, {u0, v1} };
+
+    int base = (int)vertices.size();
+    for (int i = 0; i < 4; ++i) {
+        SDL_Vertex v;
+        v.position.x = cx + corners[i][0];
+        v.position.y = cy + corners[i][1];
+        v.color = color;
+        v.tex_coord.x = uv[i][0];
+        v.tex_coord.y = uv[i][1];
+        vertices.push_back(v);
+    }
+
+    indices.push_back(base + 0);
+    indices.push_back(base + 1);
+    indices.push_back(base + 2);
+    indices.push_back(base + 0);
+    indices.push_back(base + 2);
+    indices.push_back(base + 3);
+}
+
+void SpriteBatch::flush() {
+    if (!renderer || !currentTexture || indices.empty()) {
+        vertices.clear();
+        indices.clear();
+        return;
+    }
+
+    SDL_SetTextureBlendMode(currentTexture, currentBlend);
+    if (SDL_RenderGeometry(renderer, currentTexture,
+                           vertices.data(), (int)vertices.size(),
+                           indices.data(), (int)indices.size()) != 0) {
+        std::cerr << "SpriteBatch: SDL_RenderGeometry failed: " << SDL_GetError() << std::endl;
+    }
+    ++drawCalls;
+    if (stats && stats->isCounting()) stats->countDrawCall(batchCategory);
+
+    // Keep capacity, drop contents
+    vertices.clear();
+    indices.clear();
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include "RenderStats.h"
+
+/**
+ * SpriteBatch - Collects textured quads and submits them with SDL_RenderGeometry
+ *
+ * Quads that share a texture and blend mode are merged into one draw call.
+ * The batch is flushed automatically when the texture or blend mode changes;
+ * call flush() before issuing any other renderer call so draw order is kept.
+ */
+class SpriteBatch {
+public:
+    SpriteBatch() = default;
+
+    void setRenderer(SDL_Renderer* renderer) { this->renderer = renderer; }
+
+    // Instrumentation fed while stats->isCounting()
+    void setStats(RenderStats* stats) { this->stats = stats; }
+    RenderStats* getStats() const { return stats; }
+
+    /**
+     * Queue a quad for drawing
+     * @param texture Texture to sample (must not be null)
+     * @param src Source rectangle in texture pixels, or nullptr for the whole texture
+     * @param dst Destination rectangle in screen pixels
+     * @param angle Rotation in degrees (clockwise, around the centre of dst)
+     * @param flip Horizontal/vertical flip
+     * @param color Colour and alpha modulation
+     * @param blend Blend mode used for this quad
+     */
+    void draw(SDL_Texture* texture, const SDL_Rect* src, const SDL_FRect& dst,
+              float angle = 0.0f, SDL_RendererFlip flip = SDL_FLIP_NONE,
+              SDL_Color color = {255, 255, 255, 255},
+              SDL_BlendMode blend = SDL_BLENDMODE_BLEND);
+
+    // Submit all queued quads
+    void flush();
+
+    // Number of SDL_RenderGeometry calls issued since the last resetFrameStats()
+    int getDrawCalls() const { return drawCalls; }
+    void resetFrameStats() { drawCalls = 0; }
+
+private:
+    SDL_Renderer* renderer = nullptr;
+
+    SDL_Texture* currentTexture = nullptr;
+    SDL_BlendMode currentBlend = SDL_BLENDMODE_BLEND;
+    int textureWidth = 0;
+    int textureHeight = 0;
+
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+
+    int drawCalls = 0;
+
+    RenderStats* stats = nullptr;
+    StatCategory batchCategory = StatCategory::World; // category of the first quad in the batch
+};
@@ -5,100 +5,89 @@
 #include "Engine.h"
 #include <box2d/box2d.h>
 #include <iostream>
+#include <cmath>
+#include <cstdio>
 
 SpriteComponent::SpriteComponent(const std::string& textureName) 
     : textureName(textureName) {
+    // Colour names written by SaveGame ("_COLOR_r_g_b") come back as solid colours
+    int r, g, b;
+    if (textureName.find("_COLOR_") == 0 &&
+        std::sscanf(textureName.c_str(), "_COLOR_%d_%d_%d", &r, &g, &b) == 3) {
+        solidColor = true;
+        color = SDL_Color{Uint8(r), Uint8(g), Uint8(b), 255};
+    } else {
+        texture = ImageDevice::getHandle(textureName);
+    }
 }
 
-SpriteComponent::SpriteComponent(int r, int g, int b) {
-    // Create a simple colored rectangle texture
-    // We'll use a special naming convention for colored sprites
+void SpriteComponent::setTextureName(const std::string& newTextureName) {
+    textureName = newTextureName;
+    if (!solidColor) texture = ImageDevice::getHandle(textureName);
+}
+
+SpriteComponent::SpriteComponent(int r, int g, int b)
+    : solidColor(true), color{Uint8(r), Uint8(g), Uint8(b), 255} {
+    // No texture of its own: drawn with ImageDevice's shared white texture and colour modulation
+    // The name keeps the special convention so SaveGame can round-trip it
     textureName = "_COLOR_" + std::to_string(r) + "_" + std::to_string(g) + "_" + std::to_string(b);
-    
-    // Create a 1x1 colored texture
-    SDL_Renderer* renderer = Engine::E ? Engine::E->getRenderer() : nullptr;
-    if (renderer) {
-        SDL_Surface* surface = SDL_CreateRGBSurface(0, 1, 1, 32, 0, 0, 0, 0);
-        if (surface) {
-            SDL_FillRect(surface, nullptr, SDL_MapRGB(surface->format, r, g, b));
-            texture = SDL_CreateTextureFromSurface(renderer, surface);
-            SDL_FreeSurface(surface);
-        }
-    }
 }
 
 
+// Where the texture's visible pixels land when the whole texture is stretched over rect
+static SDL_FRect visiblePart(const SDL_FRect& rect, const AlphaMask& mask, SDL_RendererFlip flip) {
+    float sx = rect.w / mask.width;
+    float sy = rect.h / mask.height;
+    const SDL_Rect& b = mask.bounds;
+    int offsetX = (flip & SDL_FLIP_HORIZONTAL) ? mask.width - b.x - b.w : b.x;
+    int offsetY = (flip & SDL_FLIP_VERTICAL) ? mask.height - b.y - b.h : b.y;
+    return SDL_FRect{rect.x + offsetX * sx, rect.y + offsetY * sy, b.w * sx, b.h * sy};
+}
+
 void SpriteComponent::draw() {
     draw(SDL_FLIP_NONE);
 }
 
 
-void SpriteComponent::draw(SDL_RendererFlip flip) {
-    SDL_Renderer* renderer = Engine::E->getRenderer();
-    SDL_Texture* tex = nullptr;
-    
-    // Check if this is a colored rectangle (starts with "_COLOR_")
-    if (textureName.find("_COLOR_") == 0) {
-        tex = texture; // Use the texture we created
-    } else {
-        tex = ImageDevice::get(textureName);
+SDL_Texture* SpriteComponent::resolveTexture() const {
+    if (solidColor) {
+        return ImageDevice::getWhiteTexture();
     }
-    
-    if (!tex) return;
-
-    SDL_Rect worldRect;
+    return ImageDevice::get(texture);
+}
 
+SDL_Rect SpriteComponent::getWorldRect() {
     BodyComponent* body = getObject()->getComponent<BodyComponent>();
-
     if (body) {
         // Object with physics uses the body
-        worldRect = body->getRect();
-    } else {
-        // STATIC IMAGE (backgrounds, clouds, trees)
-        worldRect.x = spriteX;
-        worldRect.y = spriteY;
-        worldRect.w = width;
-        worldRect.h = height;
+        return body->getRect();
     }
 
+    // STATIC IMAGE (backgrounds, clouds, trees)
+    SDL_Rect worldRect;
+    worldRect.x = spriteX;
+    worldRect.y = spriteY;
+    worldRect.w = width;
+    worldRect.h = height;
+    return worldRect;
+}
+
+void SpriteComponent::draw(SDL_RendererFlip flip) {
+    SDL_Texture* tex = resolveTexture();
+    if (!tex) return;
+
+    SDL_Rect worldRect = getWorldRect();
+    BodyComponent* body = getObject()->getComponent<BodyComponent>();
+
     SDL_Rect screenRect;
 
     if (screenSpace) {
         // Parallax: 0.0 = no movement (sky), 1.0 = full movement (foreground)
-        // Lower parallax values move slower (background layers)
-        float camX = Engine::E->getView().x;
-        float camY = Engine::E->getView().y;
-        
-        // Calculate parallax offset - background layers move slower than camera
-        float parallaxOffsetX = camX * parallaxFactor;
-        float parallaxOffsetY = camY * parallaxFactor;
-        
-        // Bidirectional infinite scrolling for backgrounds
-        if (!body && worldRect.w > 0) {
-            float viewRight = Engine::E->getView().screenWidth;
-            float screenLeft = worldRect.x - parallaxOffsetX;
-            float screenRight = (worldRect.x + worldRect.w) - parallaxOffsetX;
-            
-            // Scrolling right: when sprite's right edge reaches view's right edge
-            if (screenRight <= viewRight && parallaxOffsetX > lastParallaxOffsetX) {
-                // Reset sprite's world position so its left edge aligns with view's left edge (screen x = 0)
-                spriteX = parallaxOffsetX;
-                worldRect.x = spriteX;
-            }
-            // Scrolling left: when sprite's left edge reaches or passes view's left edge
-            else if (screenLeft >= 0 && parallaxOffsetX < lastParallaxOffsetX) {
-                // Reset sprite's world position so its right edge aligns with view's right edge
-                spriteX = parallaxOffsetX + viewRight - worldRect.w;
-                worldRect.x = spriteX;
-            }
-            
-            // Update last parallax offset for next frame (track scrolling direction)
-            lastParallaxOffsetX = parallaxOffsetX;
-        }
-        
-        // Apply parallax to world position
-        screenRect.x = int(worldRect.x - parallaxOffsetX);
-        screenRect.y = int(worldRect.y - parallaxOffsetY);
+        // Lower parallax values move slower (background layers).
+        // Repeating backgrounds should use a <ParallaxLayer> in the level instead.
+        const View& view = Engine::E->getView();
+        screenRect.x = int(worldRect.x - view.x * parallaxFactor);
+        screenRect.y = int(worldRect.y - view.y * parallaxFactor);
         screenRect.w = worldRect.w;
         screenRect.h = worldRect.h;
     }
@@ -123,11 +112,52 @@ void SpriteComponent::draw(SDL_RendererFlip flip) {
         }
     }
 
-    SDL_RenderCopyEx(renderer, tex, nullptr, &screenRect, rotation, nullptr, flip);
+    SDL_FRect full = {float(screenRect.x), float(screenRect.y), float(screenRect.w), float(screenRect.h)};
+    SDL_FRect dst = full;
+    const SDL_Rect* src = getSourceRect();
+
+    // Draw only the visible pixels. Rotated sprites keep the full rect: they rotate about its centre
+    // (mask bounds are relative to the image, which may sit anywhere in an atlas page)
+    const AlphaMask* mask = solidColor ? nullptr : ImageDevice::getAlphaMask(texture);
+    SDL_Rect trimmed;
+    if (mask && rotation == 0.0f) {
+        if (mask->bounds.w <= 0) return;
+        trimmed = mask->bounds;
+        if (src) {
+            trimmed.x += src->x;
+            trimmed.y += src->y;
+        }
+        src = &trimmed;
+        dst = visiblePart(full, *mask, flip);
+    }
+    if (rotation == 0.0f && !Engine::E->getView().isVisible(SDL_Rect{int(dst.x), int(dst.y), int(dst.w) + 1, int(dst.h) + 1})) {
+        Engine::E->getRenderQueue().countCulled(screenSpace ? RenderLayer::Background : RenderLayer::World);
+        return;
+    }
+
+    // Sorting keeps using the full bottom edge
+    if (screenSpace) {
+        Engine::E->getRenderQueue().submit(RenderLayer::Background, RenderQueue::depthFromParallax(parallaxFactor),
+                                           full.y + full.h, tex, src, dst, rotation, flip, color);
+    } else {
+        Engine::E->getRenderQueue().submit(RenderLayer::World, depth, full.y + full.h,
+                                           tex, src, dst, rotation, flip, color);
+    }
+}
+
+SDL_Rect SpriteComponent::getVisibleRect() {
+    SDL_Rect rect = getWorldRect();
+    const AlphaMask* mask = solidColor ? nullptr : ImageDevice::getAlphaMask(texture);
+    if (!mask) return rect;
+
+    SDL_FRect full = {float(rect.x), float(rect.y), float(rect.w), float(rect.h)};
+    SDL_FRect visible = visiblePart(full, *mask, flip);
+    return SDL_Rect{int(visible.x), int(visible.y), int(std::ceil(visible.w)), int(std::ceil(visible.h))};
 }
 
 void SpriteComponent::render() {
     if (!isEnabled) return; // Don't render if disabled
+    if (staticCached) return; // Already part of a static chunk texture
     draw(flip); // Use stored flip state
 }
 
@@ -2,7 +2,9 @@
 #include "Component.h"
 #include <SDL2/SDL.h>
 #include <string>
-#include "SpriteComponent.h"
+#include <cstdint>
+#include "RenderQueue.h"
+#include "ImageDevice.h"
 
 class SpriteComponent : public Component {
 public:
@@ -13,7 +15,7 @@ public:
     const std::string& getTextureName() const { return textureName; }
     
     // Setter
-    void setTextureName(const std::string& newTextureName) { textureName = newTextureName; }
+    void setTextureName(const std::string& newTextureName);
     
     // Override render method with placeholder implementation
     void render() override;
@@ -36,6 +38,10 @@ public:
     float getHeight() const { return height; }
     float getParallax() const { return parallaxFactor; }
     
+    // Draw order inside the world layer (higher draws on top)
+    void setDepth(uint16_t d) { depth = d; }
+    uint16_t getDepth() const { return depth; }
+    
     // Enable/disable rendering (useful when AnimateComponent is active)
     void setEnabled(bool enabled) { isEnabled = enabled; }
     bool getEnabled() const { return isEnabled; }
@@ -44,18 +50,40 @@ public:
     void setFlip(SDL_RendererFlip flip) { this->flip = flip; }
     SDL_RendererFlip getFlip() const { return flip; }
 
-    SDL_Texture* getTexture() const { return texture;}
+    // Solid-colour sprites draw the shared white texture tinted with this colour
+    bool isSolidColor() const { return solidColor; }
+    SDL_Color getColor() const { return color; }
+    
+    // Texture to draw (image, or the shared white texture for colours), nullptr if missing
+    SDL_Texture* resolveTexture() const;
+    // Part of resolveTexture() holding the image (its atlas region), nullptr for the whole texture
+    const SDL_Rect* getSourceRect() const { return solidColor ? nullptr : ImageDevice::getRegion(texture); }
+    
+    // World rectangle covered by the sprite (body rect, or x/y/w/h for bodiless sprites)
+    SDL_Rect getWorldRect();
+    
+    // World rectangle of the texture's visible pixels (transparent borders trimmed)
+    SDL_Rect getVisibleRect();
+    
+    bool isScreenSpace() const { return screenSpace; }
+    
+    // Set by StaticChunkCache when this sprite is drawn as part of a cached chunk
+    void setStaticCached(bool cached) { staticCached = cached; }
+    bool isStaticCached() const { return staticCached; }
 private:
     bool screenSpace = false;   // does NOT use the camera transform
     bool isEnabled = true;      // Enable/disable rendering
+    bool staticCached = false;  // drawn by StaticChunkCache instead of render()
     SDL_RendererFlip flip = SDL_FLIP_NONE; // Flip state
     std::string textureName;
-    SDL_Texture* texture = nullptr;
+    TextureHandle texture = INVALID_TEXTURE; // resolved from textureName once, not per draw
+    bool solidColor = false;
+    SDL_Color color{255, 255, 255, 255};
     float spriteX = 0;
 float spriteY = 0;
 float width = 0;
 float height = 0;
 float parallaxFactor = 1.0f; // 1 = normal, <1 = slow background, >1 = fast foreground 
-float lastParallaxOffsetX = 0.0f; // Track previous parallax offset for bidirectional scrolling
+uint16_t depth = RenderQueue::DEFAULT_WORLD_DEPTH;
 
 };
@@ -0,0 +1,213 @@
+#include "StaticChunkCache.h"
+#include "Object.h"
+#include "View.h"
+#include "RenderQueue.h"
+#include "SpriteComponent.h"
+#include "BodyComponent.h"
+#include "GroundComponent.h"
+#include "AnimateComponent.h"
+#include "Engine.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+StaticChunkCache::~StaticChunkCache() {
+    clear();
+}
+
+void StaticChunkCache::setRenderer(SDL_Renderer* r) {
+    clear();
+    renderer = r;
+    enabled = renderer && SDL_RenderTargetSupported(renderer);
+    if (renderer && !enabled) {
+        std::cout << "StaticChunkCache: Render targets not supported, static sprites will be drawn directly" << std::endl;
+    }
+
+    // Chunk textures hold premultiplied colour (sprites are blended onto a transparent target),
+    // so draw them with a premultiplied blend mode where the renderer supports it
+    chunkBlend = SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+                                            SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+    membershipDirty = true;
+}
+
+void StaticChunkCache::clear() {
+    for (auto& [key, chunk] : chunks) {
+        if (chunk.texture) SDL_DestroyTexture(chunk.texture);
+    }
+    chunks.clear();
+    membershipDirty = true;
+}
+
+void StaticChunkCache::onTargetsReset() {
+    for (auto& [key, chunk] : chunks) {
+        chunk.dirty = true;
+    }
+}
+
+uint64_t StaticChunkCache::chunkKey(int cx, int cy, uint16_t depth) {
+    return (uint64_t(uint32_t(cx) & 0xFFFFFF) << 40)
+         | (uint64_t(uint32_t(cy) & 0xFFFFFF) << 16)
+         | uint64_t(depth);
+}
+
+bool StaticChunkCache::isStaticObject(Object* obj, SpriteComponent* sprite) {
+    if (!sprite->getEnabled() || sprite->isScreenSpace()) return false;
+    if (obj->getComponent<AnimateComponent>()) return false;
+
+    // Only plain scenery: a sprite, optionally a static body and a ground marker.
+    // Anything with behaviour components may move the object by hand.
+    size_t expected = 1;
+    if (BodyComponent* body = obj->getComponent<BodyComponent>()) {
+        b2BodyId bodyId = body->getBody();
+        if (!B2_IS_NON_NULL(bodyId) || b2Body_GetType(bodyId) != b2_staticBody) return false;
+        ++expected;
+    }
+    if (obj->getComponent<GroundComponent>()) ++expected;
+
+    return obj->getComponentCount() == expected;
+}
+
+void StaticChunkCache::rebuildMembership(std::vector<std::unique_ptr<Object>>& objects) {
+    std::unordered_map<uint64_t, std::vector<Member>> newMembers;
+
+    for (auto& objPtr : objects) {
+        Object* obj = objPtr.get();
+        SpriteComponent* sprite = obj->getComponent<SpriteComponent>();
+        if (!sprite) continue;
+
+        sprite->setStaticCached(false);
+        if (!isStaticObject(obj, sprite)) continue;
+
+        SDL_Texture* tex = sprite->resolveTexture();
+        if (!tex) continue;
+
+        const SDL_Rect* region = sprite->getSourceRect();
+        Member member{tex, region ? *region : SDL_Rect{0, 0, 0, 0}, sprite->getWorldRect(),
+                      sprite->getFlip(), sprite->getColor()};
+        if (member.worldRect.w <= 0 || member.worldRect.h <= 0) continue;
+        sprite->setStaticCached(true);
+
+        // Add to every chunk the sprite overlaps
+        int x0 = (int)std::floor(member.worldRect.x / float(CHUNK_SIZE));
+        int y0 = (int)std::floor(member.worldRect.y / float(CHUNK_SIZE));
+        int x1 = (int)std::floor((member.worldRect.x + member.worldRect.w - 1) / float(CHUNK_SIZE));
+        int y1 = (int)std::floor((member.worldRect.y + member.worldRect.h - 1) / float(CHUNK_SIZE));
+        for (int cy = y0; cy <= y1; ++cy) {
+            for (int cx = x0; cx <= x1; ++cx) {
+                uint64_t key = chunkKey(cx, cy, sprite->getDepth());
+                newMembers[key].push_back(member);
+
+                // Creates the chunk on first sight (empty and dirty)
+                Chunk& chunk = chunks[key];
+                chunk.cx = cx;
+                chunk.cy = cy;
+                chunk.depth = sprite->getDepth();
+            }
+        }
+    }
+
+    // Compare with the previous contents; only changed chunks are re-rendered
+    std::vector<SDL_Texture*> unused;
+    for (auto it = chunks.begin(); it != chunks.end(); ) {
+        auto found = newMembers.find(it->first);
+        if (found == newMembers.end()) {
+            if (it->second.texture) unused.push_back(it->second.texture);
+            it = chunks.erase(it);
+            continue;
+        }
+        if (found->second != it->second.members) {
+            it->second.members = std::move(found->second);
+            it->second.dirty = true;
+        }
+        ++it;
+    }
+
+    if (!unused.empty()) {
+        for (SDL_Texture* texture : unused) RenderQueue::forgetTexture(texture);
+        // The frame in flight may still draw them
+        Engine::E->waitForFrame();
+        Engine::E->runOnRenderThread([&unused]() {
+            for (SDL_Texture* texture : unused) SDL_DestroyTexture(texture);
+        });
+    }
+
+    membershipDirty = false;
+}
+
+void StaticChunkCache::renderChunk(Chunk& chunk) {
+    if (!chunk.texture) {
+        chunk.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+                                          CHUNK_SIZE, CHUNK_SIZE);
+        if (!chunk.texture) {
+            std::cerr << "StaticChunkCache: Failed to create chunk texture: " << SDL_GetError() << std::endl;
+            return;
+        }
+        if (SDL_SetTextureBlendMode(chunk.texture, chunkBlend) != 0) {
+            // Software renderer has no custom blend modes
+            chunkBlend = SDL_BLENDMODE_BLEND;
+            SDL_SetTextureBlendMode(chunk.texture, chunkBlend);
+        }
+    }
+
+    // Anything already batched must reach the current target first
+    SpriteBatch& batch = Engine::E->getSpriteBatch();
+    batch.flush();
+
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+    SDL_SetRenderTarget(renderer, chunk.texture);
+
+    // The clear must overwrite; later untextured draws expect the mode they had
+    SDL_BlendMode previousBlend = SDL_BLENDMODE_BLEND;
+    SDL_GetRenderDrawBlendMode(renderer, &previousBlend);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+
+    int originX = chunk.cx * CHUNK_SIZE;
+    int originY = chunk.cy * CHUNK_SIZE;
+    for (const Member& m : chunk.members) {
+        SDL_FRect dst = {float(m.worldRect.x - originX), float(m.worldRect.y - originY),
+                         float(m.worldRect.w), float(m.worldRect.h)};
+        batch.draw(m.texture, m.src.w > 0 ? &m.src : nullptr, dst, 0.0f, m.flip, m.color);
+    }
+    batch.flush();
+
+    SDL_SetRenderTarget(renderer, previousTarget);
+    SDL_SetRenderDrawBlendMode(renderer, previousBlend);
+    chunk.dirty = false;
+}
+
+void StaticChunkCache::submit(std::vector<std::unique_ptr<Object>>& objects, const View& view, RenderQueue& queue) {
+    if (!enabled) return;
+
+    if (membershipDirty) {
+        rebuildMembership(objects);
+    }
+
+    // Visible world rectangle
+    float viewW = view.screenWidth / view.scale;
+    float viewH = view.screenHeight / view.scale;
+    int x0 = (int)std::floor(view.x / CHUNK_SIZE);
+    int y0 = (int)std::floor(view.y / CHUNK_SIZE);
+    int x1 = (int)std::floor((view.x + viewW) / CHUNK_SIZE);
+    int y1 = (int)std::floor((view.y + viewH) / CHUNK_SIZE);
+
+    for (auto& [key, chunk] : chunks) {
+        if (chunk.cx < x0 || chunk.cx > x1 || chunk.cy < y0 || chunk.cy > y1) continue;
+
+        if (chunk.dirty || !chunk.texture) {
+            // Render targets are only touched where the renderer lives
+            Engine::E->runOnRenderThread([this, &chunk]() { renderChunk(chunk); });
+            if (!chunk.texture) continue;
+        }
+
+        SDL_Rect worldRect = {chunk.cx * CHUNK_SIZE, chunk.cy * CHUNK_SIZE, CHUNK_SIZE, CHUNK_SIZE};
+        SDL_Rect screen = view.transform(worldRect);
+        SDL_FRect dst = {float(screen.x), float(screen.y), float(screen.w), float(screen.h)};
+
+        // Static scenery sits just beneath moving sprites of the same depth
+        uint16_t depth = chunk.depth > 0 ? uint16_t(chunk.depth - 1) : 0;
+        queue.submit(RenderLayer::World, depth, 0.0f, chunk.texture, nullptr, dst,
+                     0.0f, SDL_FLIP_NONE, SDL_Color{255, 255, 255, 255}, chunkBlend);
+    }
+}
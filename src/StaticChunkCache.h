@@ -0,0 +1,91 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class Object;
+class View;
+class RenderQueue;
+class SpriteComponent;
+
+/**
+ * StaticChunkCache - Pre-renders static scenery into per-chunk target textures
+ *
+ * The world is split into fixed-size chunks. Sprites that never move (no body
+ * or a static body, no animation and no behaviour components) are drawn once
+ * into a SDL_TEXTUREACCESS_TARGET texture per chunk and depth, and each frame
+ * only the visible chunk textures are queued. Membership is recomputed only
+ * after invalidate() (objects added or removed); chunks whose contents did not
+ * change keep their texture.
+ */
+class StaticChunkCache {
+public:
+    static constexpr int CHUNK_SIZE = 512;
+
+    StaticChunkCache() = default;
+    ~StaticChunkCache();
+
+    void setRenderer(SDL_Renderer* renderer);
+
+    // Mark membership stale (call when objects are added, removed or moved by hand)
+    void invalidate() { membershipDirty = true; }
+
+    // Destroy every chunk texture and forget all members (call where the renderer lives)
+    void clear();
+
+    // Re-render every chunk on next use (render target contents were lost)
+    void onTargetsReset();
+
+    /**
+     * Queue the visible chunks, rebuilding membership and chunk textures if needed
+     * @param objects All engine objects
+     * @param view Camera used for visibility
+     * @param queue Render queue to submit chunk quads to
+     */
+    void submit(std::vector<std::unique_ptr<Object>>& objects, const View& view, RenderQueue& queue);
+
+    bool isEnabled() const { return enabled; }
+    int getChunkCount() const { return (int)chunks.size(); }
+
+private:
+    // A static sprite as it will be drawn into a chunk
+    struct Member {
+        SDL_Texture* texture;
+        SDL_Rect src;         // atlas region (w = 0 for the whole texture)
+        SDL_Rect worldRect;
+        SDL_RendererFlip flip;
+        SDL_Color color;
+
+        bool operator==(const Member& o) const {
+            return texture == o.texture && flip == o.flip
+                && src.x == o.src.x && src.y == o.src.y && src.w == o.src.w && src.h == o.src.h
+                && color.r == o.color.r && color.g == o.color.g && color.b == o.color.b && color.a == o.color.a
+                && worldRect.x == o.worldRect.x && worldRect.y == o.worldRect.y
+                && worldRect.w == o.worldRect.w && worldRect.h == o.worldRect.h;
+        }
+    };
+
+    struct Chunk {
+        int cx = 0;
+        int cy = 0;
+        uint16_t depth = 0;
+        std::vector<Member> members;
+        SDL_Texture* texture = nullptr;
+        bool dirty = true;
+    };
+
+    static uint64_t chunkKey(int cx, int cy, uint16_t depth);
+    static bool isStaticObject(Object* obj, SpriteComponent* sprite);
+
+    void rebuildMembership(std::vector<std::unique_ptr<Object>>& objects);
+    void renderChunk(Chunk& chunk);
+
+    SDL_Renderer* renderer = nullptr;
+    bool enabled = false;
+    bool membershipDirty = true;
+    SDL_BlendMode chunkBlend = SDL_BLENDMODE_BLEND;
+
+    std::unordered_map<uint64_t, Chunk> chunks;
+};
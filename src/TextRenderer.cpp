@@ -0,0 +1,134 @@
+#include "TextRenderer.h"
+#include "Engine.h"
+#include <SDL_ttf.h>
+#include <algorithm>
+#include <iostream>
+
+// Static member definitions
+std::unordered_map<std::string, std::unique_ptr<GlyphAtlas>> TextRenderer::fonts;
+std::unordered_map<std::string, TextRenderer::Layout> TextRenderer::layouts;
+TextRenderer::Layout TextRenderer::scratchLayout;
+
+// Cached layouts are dropped wholesale past this many, so stray dynamic strings cannot grow the cache forever
+static const size_t MAX_CACHED_LAYOUTS = 512;
+
+bool TextRenderer::loadFont(const std::string& name, const std::string& path, int pointSize) {
+    if (TTF_WasInit() == 0 && TTF_Init() == -1) {
+        std::cerr << "TextRenderer: TTF_Init failed: " << TTF_GetError() << std::endl;
+        return false;
+    }
+
+    auto atlas = std::make_unique<GlyphAtlas>();
+    if (!atlas->load(path, pointSize)) {
+        return false;
+    }
+
+    // Layouts made with a previous font of this name are stale
+    if (fonts.count(name)) {
+        layouts.clear();
+        GlyphAtlas* old = fonts[name].release();
+        RenderQueue::forgetTexture(old->getTexture());
+        Engine::E->waitForFrame();
+        Engine::E->runOnRenderThread([old]() { delete old; });
+    }
+    fonts[name] = std::move(atlas);
+    return true;
+}
+
+bool TextRenderer::hasFont(const std::string& name) {
+    return fonts.find(name) != fonts.end();
+}
+
+void TextRenderer::buildLayout(const GlyphAtlas& atlas, const std::string& text, Layout& layout) {
+    layout.src.clear();
+    layout.dst.clear();
+    layout.width = 0;
+    layout.height = atlas.getLineHeight();
+
+    int penX = 0;
+    int penY = 0;
+    Uint32 previous = 0;
+    for (unsigned char c : text) {
+        if (c == '\n') {
+            layout.width = std::max(layout.width, penX);
+            penX = 0;
+            penY += atlas.getLineHeight();
+            layout.height += atlas.getLineHeight();
+            previous = 0;
+            continue;
+        }
+
+        Uint32 ch = c;
+        if (previous) penX += atlas.getKerning(previous, ch);
+        previous = ch;
+
+        const Glyph& glyph = atlas.getGlyph(ch);
+        if (glyph.src.w > 0 && glyph.src.h > 0) {
+            layout.src.push_back(glyph.src);
+            layout.dst.push_back(SDL_FRect{float(penX + glyph.offsetX), float(penY),
+                                           float(glyph.src.w), float(glyph.src.h)});
+        }
+        penX += glyph.advance;
+    }
+    layout.width = std::max(layout.width, penX);
+}
+
+const TextRenderer::Layout* TextRenderer::getLayout(const std::string& fontName, GlyphAtlas& atlas,
+                                                    const std::string& text, bool cache) {
+    if (!cache) {
+        buildLayout(atlas, text, scratchLayout);
+        return &scratchLayout;
+    }
+
+    std::string key = fontName;
+    key.push_back('\0');
+    key += text;
+
+    auto it = layouts.find(key);
+    if (it != layouts.end()) return &it->second;
+
+    if (layouts.size() >= MAX_CACHED_LAYOUTS) {
+        layouts.clear();
+    }
+    Layout& layout = layouts[key];
+    buildLayout(atlas, text, layout);
+    return &layout;
+}
+
+void TextRenderer::draw(const std::string& fontName, const std::string& text, float x, float y,
+                        SDL_Color color, TextAlign align, RenderLayer layer, uint16_t depth, bool cache) {
+    auto it = fonts.find(fontName);
+    if (it == fonts.end() || text.empty()) return;
+
+    GlyphAtlas& atlas = *it->second;
+    const Layout* layout = getLayout(fontName, atlas, text, cache);
+
+    float originX = x;
+    if (align == TextAlign::Center) originX -= layout->width / 2.0f;
+    else if (align == TextAlign::Right) originX -= float(layout->width);
+    // Whole pixels keep glyph edges crisp
+    originX = float(int(originX));
+    float originY = float(int(y));
+
+    RenderQueue& queue = Engine::E->getRenderQueue();
+    SDL_Texture* texture = atlas.getTexture();
+    for (size_t i = 0; i < layout->src.size(); ++i) {
+        const SDL_FRect& d = layout->dst[i];
+        SDL_FRect dst = {originX + d.x, originY + d.y, d.w, d.h};
+        queue.submit(layer, depth, 0.0f, texture, &layout->src[i], dst, 0.0f, SDL_FLIP_NONE, color);
+    }
+}
+
+SDL_Point TextRenderer::measure(const std::string& fontName, const std::string& text) {
+    auto it = fonts.find(fontName);
+    if (it == fonts.end()) return SDL_Point{0, 0};
+
+    const Layout* layout = getLayout(fontName, *it->second, text, true);
+    return SDL_Point{layout->width, layout->height};
+}
+
+void TextRenderer::cleanup() {
+    layouts.clear();
+    fonts.clear();
+    if (TTF_WasInit()) TTF_Quit();
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "GlyphAtlas.h"
+#include "RenderQueue.h"
+
+enum class TextAlign {
+    Left,
+    Center,
+    Right
+};
+
+/**
+ * TextRenderer - Named fonts baked into glyph atlases, and cached text layouts
+ *
+ * Works like ImageDevice: fonts are loaded once by name and drawn by name.
+ * Laying out a string (glyph lookup, kerning, line breaks) happens once per
+ * font and content; the cached quads are then queued every frame, tinted with
+ * the requested colour, so a string in any colour reuses the same layout.
+ */
+class TextRenderer {
+public:
+    // Font shipped with the game (assets/fonts)
+    static constexpr const char* DEFAULT_FONT_PATH = "assets/fonts/DejaVuSans.ttf";
+
+    /**
+     * Load a font at a point size and bake its atlas
+     * @param name Name used to draw with it
+     * @param path TTF file
+     * @param pointSize Size in points
+     */
+    static bool loadFont(const std::string& name, const std::string& path, int pointSize);
+
+    static bool hasFont(const std::string& name);
+
+    /**
+     * Queue a string (screen space)
+     * @param x,y Anchor; y is the top of the first line, x depends on align
+     * @param cache Keep the layout for the next frame (turn off for text that changes every frame)
+     */
+    static void draw(const std::string& fontName, const std::string& text, float x, float y,
+                     SDL_Color color, TextAlign align = TextAlign::Left,
+                     RenderLayer layer = RenderLayer::HUD, uint16_t depth = 1, bool cache = true);
+
+    // Size of a string in pixels
+    static SDL_Point measure(const std::string& fontName, const std::string& text);
+
+    // Release atlases and layouts (call where the renderer lives, before it is destroyed)
+    static void cleanup();
+
+private:
+    struct Layout {
+        std::vector<SDL_Rect> src;
+        std::vector<SDL_FRect> dst; // relative to the top-left of the text
+        int width = 0;
+        int height = 0;
+    };
+
+    static void buildLayout(const GlyphAtlas& atlas, const std::string& text, Layout& layout);
+    static const Layout* getLayout(const std::string& fontName, GlyphAtlas& atlas, const std::string& text, bool cache);
+
+    static std::unordered_map<std::string, std::unique_ptr<GlyphAtlas>> fonts;
+    static std::unordered_map<std::string, Layout> layouts; // key: font name + '\0' + text
+    static Layout scratchLayout;                            // for uncached text
+};
@@ -0,0 +1,195 @@
+#include "TextureAtlas.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+SkylinePacker::SkylinePacker(int width, int height)
+    : width(width), height(height) {
+    skyline.push_back(Segment{0, 0, width});
+}
+
+int SkylinePacker::fitAt(size_t index, int w, int h) const {
+    int x = skyline[index].x;
+    if (x + w > width) return -1;
+
+    int y = 0;
+    int remaining = w;
+    for (size_t i = index; remaining > 0 && i < skyline.size(); ++i) {
+        y = std::max(y, skyline[i].y);
+        if (y + h > height) return -1;
+        remaining -= skyline[i].width;
+    }
+    return y;
+}
+
+bool SkylinePacker::insert(int w, int h, SDL_Point& position) {
+    if (w <= 0 || h <= 0) return false;
+
+    // Lowest resting place; ties go to the narrowest segment so wide gaps stay open
+    size_t best = skyline.size();
+    int bestBottom = 0, bestWidth = 0;
+    for (size_t i = 0; i < skyline.size(); ++i) {
+        int y = fitAt(i, w, h);
+        if (y < 0) continue;
+        if (best == skyline.size() || y + h < bestBottom || (y + h == bestBottom && skyline[i].width < bestWidth)) {
+            best = i;
+            bestBottom = y + h;
+            bestWidth = skyline[i].width;
+        }
+    }
+    if (best == skyline.size()) return false;
+
+    position = SDL_Point{skyline[best].x, bestBottom - h};
+    skyline.insert(skyline.begin() + best, Segment{position.x, bestBottom, w});
+
+    // Cut away the segments now underneath the new one
+    int right = position.x + w;
+    for (size_t i = best + 1; i < skyline.size(); ) {
+        if (skyline[i].x >= right) break;
+        int overlap = right - skyline[i].x;
+        skyline[i].x += overlap;
+        skyline[i].width -= overlap;
+        if (skyline[i].width > 0) break;
+        skyline.erase(skyline.begin() + i);
+    }
+
+    // Merge neighbours at the same height
+    for (size_t i = 0; i + 1 < skyline.size(); ) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        } else {
+            ++i;
+        }
+    }
+
+    usedHeight = std::max(usedHeight, bestBottom);
+    return true;
+}
+
+
+TextureAtlas::TextureAtlas(int pageSize, int padding, int extrude)
+    : pageSize(pageSize), padding(std::max(padding, 0)), extrude(std::max(extrude, 0)) {
+}
+
+TextureAtlas::~TextureAtlas() {
+    for (SDL_Surface* page : pages) SDL_FreeSurface(page);
+}
+
+bool TextureAtlas::accepts(int w, int h, int maxEntry) const {
+    int margin = 2 * extrude + padding;
+    return w > 0 && h > 0 && w <= maxEntry && h <= maxEntry &&
+           w + margin <= pageSize && h + margin <= pageSize;
+}
+
+void TextureAtlas::add(const std::string& name, SDL_Surface* surface) {
+    pending.push_back(Pending{name, surface});
+}
+
+bool TextureAtlas::pack(Uint32 format) {
+    int margin = 2 * extrude + padding;
+
+    // Tallest first keeps the skyline flat
+    std::vector<size_t> order(pending.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        const SDL_Surface* sa = pending[a].surface;
+        const SDL_Surface* sb = pending[b].surface;
+        return sa->h != sb->h ? sa->h > sb->h : sa->w > sb->w;
+    });
+
+    std::vector<SkylinePacker> packers;
+    std::vector<SDL_Point> extents;  // used width/height per page
+    std::vector<size_t> placedOrder;
+    regions.clear();
+    regions.resize(pending.size());
+    for (size_t index : order) {
+        SDL_Surface* surface = pending[index].surface;
+        int cellW = surface->w + margin;
+        int cellH = surface->h + margin;
+
+        SDL_Point position{0, 0};
+        size_t page = 0;
+        while (page < packers.size() && !packers[page].insert(cellW, cellH, position)) ++page;
+        if (page == packers.size()) {
+            packers.emplace_back(pageSize, pageSize);
+            extents.push_back(SDL_Point{0, 0});
+            if (!packers.back().insert(cellW, cellH, position)) {
+                std::cerr << "TextureAtlas: '" << pending[index].name << "' does not fit a page" << std::endl;
+                packers.pop_back();
+                extents.pop_back();
+                continue;
+            }
+        }
+
+        extents[page].x = std::max(extents[page].x, position.x + cellW);
+        extents[page].y = std::max(extents[page].y, position.y + cellH);
+        Region& region = regions[index];
+        region.name = pending[index].name;
+        region.page = page;
+        region.rect = SDL_Rect{position.x + extrude, position.y + extrude, surface->w, surface->h};
+        placedOrder.push_back(index);
+    }
+
+    // Pages are cropped to what they use; the trailing padding is not needed there
+    for (const SDL_Point& extent : extents) {
+        int w = std::max(extent.x - padding, 1);
+        int h = std::max(extent.y - padding, 1);
+        SDL_Surface* page = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, format);
+        if (!page) {
+            std::cerr << "TextureAtlas: Failed to create a " << w << "x" << h << " page: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        SDL_FillRect(page, nullptr, SDL_MapRGBA(page->format, 0, 0, 0, 0));
+        pages.push_back(page);
+    }
+
+    for (size_t index : placedOrder) {
+        SDL_Surface* surface = pending[index].surface;
+        const Region& region = regions[index];
+        SDL_Surface* page = pages[region.page];
+
+        // Straight copy, alpha included
+        SDL_BlendMode previous;
+        SDL_GetSurfaceBlendMode(surface, &previous);
+        SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+        SDL_Rect dst = region.rect;
+        if (SDL_BlitSurface(surface, nullptr, page, &dst) != 0) {
+            std::cerr << "TextureAtlas: Failed to blit '" << region.name << "': " << SDL_GetError() << std::endl;
+        }
+        SDL_SetSurfaceBlendMode(surface, previous);
+        extrudeEdges(page, region.rect);
+    }
+
+    // Images that did not fit have an empty region
+    regions.erase(std::remove_if(regions.begin(), regions.end(),
+                                 [](const Region& r) { return r.rect.w == 0; }), regions.end());
+    pending.clear();
+    return true;
+}
+
+void TextureAtlas::extrudeEdges(SDL_Surface* page, const SDL_Rect& rect) const {
+    if (extrude == 0) return;
+
+    SDL_LockSurface(page);
+    auto pixel = [page](int x, int y) {
+        return reinterpret_cast<Uint32*>(static_cast<Uint8*>(page->pixels) + size_t(y) * page->pitch) + x;
+    };
+
+    // Left and right columns first, then whole rows (corners included) up and down
+    for (int y = rect.y; y < rect.y + rect.h; ++y) {
+        Uint32 left = *pixel(rect.x, y);
+        Uint32 right = *pixel(rect.x + rect.w - 1, y);
+        for (int e = 1; e <= extrude; ++e) {
+            *pixel(rect.x - e, y) = left;
+            *pixel(rect.x + rect.w - 1 + e, y) = right;
+        }
+    }
+    size_t rowBytes = size_t(rect.w + 2 * extrude) * 4;
+    for (int e = 1; e <= extrude; ++e) {
+        std::memcpy(pixel(rect.x - extrude, rect.y - e), pixel(rect.x - extrude, rect.y), rowBytes);
+        std::memcpy(pixel(rect.x - extrude, rect.y + rect.h - 1 + e),
+                    pixel(rect.x - extrude, rect.y + rect.h - 1), rowBytes);
+    }
+    SDL_UnlockSurface(page);
+}
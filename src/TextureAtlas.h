@@ -0,0 +1,93 @@
+#pragma once
+#include <SDL.h>
+#include <string>
+#include <vector>
+
+/**
+ * Skyline bottom-left rectangle packer
+ *
+ * Keeps the top edge of everything placed so far as a list of horizontal
+ * segments and puts each new rectangle where its bottom ends up lowest.
+ * Feeding rectangles tallest first keeps the skyline flat.
+ */
+class SkylinePacker {
+public:
+    SkylinePacker(int width, int height);
+
+    // Place a w x h rectangle; false if it does not fit
+    bool insert(int w, int h, SDL_Point& position);
+
+    // Lowest y every placed rectangle lies above
+    int getUsedHeight() const { return usedHeight; }
+
+private:
+    struct Segment {
+        int x;
+        int y;
+        int width;
+    };
+
+    // y a rectangle of width w would rest at when its left edge is on segment index; -1 if it does not fit
+    int fitAt(size_t index, int w, int h) const;
+
+    int width;
+    int height;
+    int usedHeight = 0;
+    std::vector<Segment> skyline;
+};
+
+/**
+ * TextureAtlas - Packs many small images into a few large surfaces
+ *
+ * Images are added as decoded surfaces and pack() lays them out on pages of
+ * at most pageSize pixels. Every image is surrounded by `extrude` copies of its
+ * own edge pixels and `padding` transparent pixels, so filtering and sub-pixel
+ * positions near a region's edge never pick up a neighbour. Pages are cropped
+ * to the height they use. Pure CPU work: pages are uploaded by the caller.
+ */
+class TextureAtlas {
+public:
+    struct Region {
+        std::string name;
+        size_t page = 0;
+        SDL_Rect rect{0, 0, 0, 0};  // the image inside its page, without extrusion
+    };
+
+    TextureAtlas(int pageSize, int padding, int extrude);
+    ~TextureAtlas();
+
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    // Whether an image of this size is worth packing and fits a page
+    bool accepts(int w, int h, int maxEntry) const;
+
+    // Queue an image (the atlas does not take ownership)
+    void add(const std::string& name, SDL_Surface* surface);
+
+    /**
+     * Lay out and blit every queued image
+     * @param format Pixel format of the pages (must be 32 bits per pixel)
+     * @return false if a page could not be created
+     */
+    bool pack(Uint32 format);
+
+    const std::vector<Region>& getRegions() const { return regions; }
+    const std::vector<SDL_Surface*>& getPages() const { return pages; }
+
+private:
+    struct Pending {
+        std::string name;
+        SDL_Surface* surface;
+    };
+
+    // Copy the outermost rows and columns of rect outwards into the margin
+    void extrudeEdges(SDL_Surface* page, const SDL_Rect& rect) const;
+
+    int pageSize;
+    int padding;
+    int extrude;
+    std::vector<Pending> pending;
+    std::vector<Region> regions;
+    std::vector<SDL_Surface*> pages;
+};
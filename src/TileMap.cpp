@@ -0,0 +1,236 @@
+#include "TileMap.h"
+#include "ImageDevice.h"
+#include "RenderQueue.h"
+#include "View.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+TileMap::TileMap(int cols, int rows, float tileSize, float originX, float originY)
+    : cols(std::max(cols, 0)),
+      rows(std::max(rows, 0)),
+      tileSize(tileSize > 0.0f ? tileSize : 1.0f),
+      originX(originX),
+      originY(originY),
+      depth(RenderQueue::DEFAULT_WORLD_DEPTH - 1)
+{
+    chunkCols = (this->cols + CHUNK_TILES - 1) / CHUNK_TILES;
+    chunkRows = (this->rows + CHUNK_TILES - 1) / CHUNK_TILES;
+    chunks.resize(size_t(chunkCols) * chunkRows);
+}
+
+TileMap::~TileMap() {
+    destroyCollision();
+}
+
+bool TileMap::setTileset(const std::string& textureName, int tileSourceSize, int tileSpacing) {
+    if (!ImageDevice::get(textureName)) return false;
+    texture = ImageDevice::getHandle(textureName);
+
+    // The sheet may be a region of an atlas page
+    sheetArea = ImageDevice::getArea(texture);
+    sourceTileSize = std::max(tileSourceSize, 1);
+    spacing = std::max(tileSpacing, 0);
+    sheetColumns = std::max((sheetArea.w + spacing) / (sourceTileSize + spacing), 1);
+
+    for (Chunk& chunk : chunks) chunk.quadsDirty = true;
+    return true;
+}
+
+TileMap::Chunk* TileMap::chunkAt(int col, int row) {
+    if (col < 0 || row < 0 || col >= cols || row >= rows) return nullptr;
+    return &chunks[size_t(row / CHUNK_TILES) * chunkCols + col / CHUNK_TILES];
+}
+
+const TileMap::Chunk* TileMap::chunkAt(int col, int row) const {
+    if (col < 0 || row < 0 || col >= cols || row >= rows) return nullptr;
+    return &chunks[size_t(row / CHUNK_TILES) * chunkCols + col / CHUNK_TILES];
+}
+
+void TileMap::setTile(int col, int row, uint16_t tile) {
+    Chunk* chunk = chunkAt(col, row);
+    if (!chunk) return;
+    if (chunk->tiles.empty()) {
+        if (tile == EMPTY) return;
+        chunk->tiles.assign(CHUNK_TILES * CHUNK_TILES, EMPTY);
+    }
+    chunk->tiles[(row % CHUNK_TILES) * CHUNK_TILES + col % CHUNK_TILES] = tile;
+    chunk->quadsDirty = true;
+}
+
+uint16_t TileMap::getTile(int col, int row) const {
+    const Chunk* chunk = chunkAt(col, row);
+    if (!chunk || chunk->tiles.empty()) return EMPTY;
+    return chunk->tiles[(row % CHUNK_TILES) * CHUNK_TILES + col % CHUNK_TILES];
+}
+
+void TileMap::fill(int col, int row, int fillCols, int fillRows, uint16_t tile) {
+    for (int r = row; r < row + fillRows; ++r) {
+        for (int c = col; c < col + fillCols; ++c) {
+            setTile(c, r, tile);
+        }
+    }
+}
+
+void TileMap::setSolid(uint16_t tile, bool solid) {
+    if (tile == EMPTY) return;
+    if (tile >= nonSolid.size()) nonSolid.resize(size_t(tile) + 1, false);
+    nonSolid[tile] = !solid;
+}
+
+bool TileMap::isSolid(uint16_t tile) const {
+    if (tile == EMPTY) return false;
+    return tile >= nonSolid.size() || !nonSolid[tile];
+}
+
+void TileMap::buildQuads(int chunkX, int chunkY, Chunk& chunk) {
+    chunk.src.clear();
+    chunk.dst.clear();
+    chunk.quadsDirty = false;
+    if (chunk.tiles.empty()) return;
+
+    for (int ty = 0; ty < CHUNK_TILES; ++ty) {
+        for (int tx = 0; tx < CHUNK_TILES; ++tx) {
+            uint16_t tile = chunk.tiles[ty * CHUNK_TILES + tx];
+            if (tile == EMPTY) continue;
+
+            int col = chunkX * CHUNK_TILES + tx;
+            int row = chunkY * CHUNK_TILES + ty;
+            int step = sourceTileSize + spacing;
+            chunk.src.push_back(SDL_Rect{sheetArea.x + (tile % sheetColumns) * step,
+                                         sheetArea.y + (tile / sheetColumns) * step,
+                                         sourceTileSize, sourceTileSize});
+            chunk.dst.push_back(SDL_FRect{originX + col * tileSize, originY + row * tileSize,
+                                          tileSize, tileSize});
+        }
+    }
+}
+
+void TileMap::submit(const View& view, RenderQueue& queue) {
+    if (texture == INVALID_TEXTURE || chunks.empty()) return;
+
+    // An evicted sheet comes back wherever its batch packed it; the cached quads follow
+    SDL_Texture* sheet = ImageDevice::get(texture);
+    SDL_Rect area = ImageDevice::getArea(texture);
+    if (area.x != sheetArea.x || area.y != sheetArea.y) {
+        sheetArea = area;
+        for (Chunk& chunk : chunks) chunk.quadsDirty = true;
+    }
+
+    // Chunks overlapping the screen
+    float chunkWorld = CHUNK_TILES * tileSize;
+    float viewW = view.screenWidth / view.scale;
+    float viewH = view.screenHeight / view.scale;
+    int firstX = std::max(int(std::floor((view.x - originX) / chunkWorld)), 0);
+    int firstY = std::max(int(std::floor((view.y - originY) / chunkWorld)), 0);
+    int lastX = std::min(int(std::floor((view.x + viewW - originX) / chunkWorld)), chunkCols - 1);
+    int lastY = std::min(int(std::floor((view.y + viewH - originY) / chunkWorld)), chunkRows - 1);
+
+    for (int cy = firstY; cy <= lastY; ++cy) {
+        for (int cx = firstX; cx <= lastX; ++cx) {
+            Chunk& chunk = chunks[size_t(cy) * chunkCols + cx];
+            if (chunk.tiles.empty()) continue;
+            if (chunk.quadsDirty) buildQuads(cx, cy, chunk);
+
+            for (size_t i = 0; i < chunk.dst.size(); ++i) {
+                const SDL_FRect& d = chunk.dst[i];
+                // Whole pixels (and one extra) so neighbouring tiles never leave a seam
+                float x0 = std::floor((d.x - view.x) * view.scale);
+                float y0 = std::floor((d.y - view.y) * view.scale);
+                float x1 = std::floor((d.x + d.w - view.x) * view.scale);
+                float y1 = std::floor((d.y + d.h - view.y) * view.scale);
+                SDL_FRect dst = {x0, y0, x1 - x0, y1 - y0};
+                queue.submit(RenderLayer::World, depth, 0.0f, sheet, &chunk.src[i], dst);
+            }
+        }
+    }
+}
+
+void TileMap::buildChunkCollision(int chunkX, int chunkY, Chunk& chunk, float worldHeight) {
+    if (chunk.tiles.empty()) return;
+
+    // Greedy merge: grow each unclaimed solid tile right, then down while the whole span stays solid
+    bool claimed[CHUNK_TILES * CHUNK_TILES] = {};
+    auto solidAt = [&](int tx, int ty) {
+        return !claimed[ty * CHUNK_TILES + tx] && isSolid(chunk.tiles[ty * CHUNK_TILES + tx]);
+    };
+
+    // The body sits at the chunk's top-left corner; shapes are offset from it
+    float chunkLeft = originX + chunkX * CHUNK_TILES * tileSize;
+    float chunkTop = originY + chunkY * CHUNK_TILES * tileSize;
+
+    b2ShapeDef shapeDef = b2DefaultShapeDef();
+    shapeDef.material.friction = 0.3f;
+
+    for (int ty = 0; ty < CHUNK_TILES; ++ty) {
+        for (int tx = 0; tx < CHUNK_TILES; ++tx) {
+            if (!solidAt(tx, ty)) continue;
+
+            int w = 1;
+            while (tx + w < CHUNK_TILES && solidAt(tx + w, ty)) ++w;
+
+            int h = 1;
+            while (ty + h < CHUNK_TILES) {
+                bool rowSolid = true;
+                for (int i = 0; i < w && rowSolid; ++i) rowSolid = solidAt(tx + i, ty + h);
+                if (!rowSolid) break;
+                ++h;
+            }
+
+            for (int y = ty; y < ty + h; ++y) {
+                for (int x = tx; x < tx + w; ++x) claimed[y * CHUNK_TILES + x] = true;
+            }
+
+            if (B2_IS_NULL(chunk.body)) {
+                b2BodyDef bodyDef = b2DefaultBodyDef();
+                bodyDef.type = b2_staticBody;
+                bodyDef.position = b2Vec2{chunkLeft, worldHeight - chunkTop};
+                chunk.body = b2CreateBody(world, &bodyDef);
+            }
+
+            // Offset of the rectangle's centre from the body, Y up
+            float halfW = w * tileSize / 2;
+            float halfH = h * tileSize / 2;
+            b2Vec2 center = b2Vec2{tx * tileSize + halfW, -(ty * tileSize + halfH)};
+            b2Polygon box = b2MakeOffsetBox(halfW, halfH, center, b2Rot_identity);
+            b2CreatePolygonShape(chunk.body, &shapeDef, &box);
+            ++shapeCount;
+        }
+    }
+}
+
+void TileMap::buildCollision(b2WorldId newWorld, float worldHeight) {
+    destroyCollision();
+    world = newWorld;
+    if (B2_IS_NULL(world)) return;
+
+    for (int cy = 0; cy < chunkRows; ++cy) {
+        for (int cx = 0; cx < chunkCols; ++cx) {
+            buildChunkCollision(cx, cy, chunks[size_t(cy) * chunkCols + cx], worldHeight);
+        }
+    }
+}
+
+void TileMap::destroyCollision() {
+    for (Chunk& chunk : chunks) {
+        if (B2_IS_NON_NULL(chunk.body) && b2Body_IsValid(chunk.body)) {
+            b2DestroyBody(chunk.body);
+        }
+        chunk.body = b2_nullBodyId;
+    }
+    shapeCount = 0;
+}
+
+bool TileMap::overlapsSolid(float x, float y, float w, float h) const {
+    int firstCol = std::max(int(std::floor((x - originX) / tileSize)), 0);
+    int firstRow = std::max(int(std::floor((y - originY) / tileSize)), 0);
+    int lastCol = std::min(int(std::floor((x + w - originX) / tileSize)), cols - 1);
+    int lastRow = std::min(int(std::floor((y + h - originY) / tileSize)), rows - 1);
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int col = firstCol; col <= lastCol; ++col) {
+            if (isSolid(getTile(col, row))) return true;
+        }
+    }
+    return false;
+}
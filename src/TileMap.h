@@ -0,0 +1,110 @@
+#pragma once
+#include <SDL.h>
+#include <box2d/box2d.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ImageDevice.h"
+
+class View;
+class RenderQueue;
+
+/**
+ * TileMap - A grid of tile indices drawn from one tile sheet, stored in chunks
+ *
+ * Declared in level XML:
+ *   <TileMap tileset="terrain" sourceTileSize="16" tileSize="50" x="-25" y="700" cols="108" rows="2">
+ *       <Fill col="0" row="0" cols="108" rows="1" tile="7" />
+ *       <Data row="1">29,29,29,-1,29</Data>
+ *   </TileMap>
+ *
+ * Each chunk of CHUNK_TILES x CHUNK_TILES tiles keeps its own index array,
+ * a cached list of tile quads (rebuilt only when one of its tiles changes)
+ * and one static Box2D body whose shapes are the solid tiles greedily merged
+ * into as few rectangles as possible. Empty chunks hold no tiles at all, so
+ * memory and load time follow the number of tiles rather than objects.
+ */
+class TileMap {
+public:
+    static constexpr int CHUNK_TILES = 16;
+    static constexpr uint16_t EMPTY = 0xFFFF;
+
+    /**
+     * @param cols,rows Size of the map in tiles
+     * @param tileSize Size of a tile in world pixels
+     * @param originX,originY World position of the top-left corner
+     */
+    TileMap(int cols, int rows, float tileSize, float originX, float originY);
+    ~TileMap();
+
+    TileMap(const TileMap&) = delete;
+    TileMap& operator=(const TileMap&) = delete;
+
+    /**
+     * Tile sheet the indices refer to (row-major, sourceTileSize pixel cells)
+     * @return false if the texture cannot be loaded
+     */
+    bool setTileset(const std::string& textureName, int sourceTileSize, int spacing = 0);
+
+    void setTile(int col, int row, uint16_t tile);
+    uint16_t getTile(int col, int row) const;
+    void fill(int col, int row, int cols, int rows, uint16_t tile);
+
+    // Tiles are solid unless marked otherwise
+    void setSolid(uint16_t tile, bool solid);
+    bool isSolid(uint16_t tile) const;
+
+    // Draw order inside the world layer (defaults to just behind sprites)
+    void setDepth(uint16_t d) { depth = d; }
+
+    /**
+     * Create the static bodies for every chunk (replaces previous ones)
+     * @param worldHeight Used for the SDL (Y down) to Box2D (Y up) conversion, as in BodyComponent
+     */
+    void buildCollision(b2WorldId world, float worldHeight);
+    void destroyCollision();
+
+    // Queue the visible chunks' tiles
+    void submit(const View& view, RenderQueue& queue);
+
+    // Whether a world rectangle (SDL coordinates) touches a solid tile
+    bool overlapsSolid(float x, float y, float w, float h) const;
+
+    int getColumns() const { return cols; }
+    int getRows() const { return rows; }
+    int getShapeCount() const { return shapeCount; }
+
+private:
+    struct Chunk {
+        std::vector<uint16_t> tiles;   // CHUNK_TILES^2, or empty while the chunk has none
+        std::vector<SDL_Rect> src;     // cached quads for the chunk's tiles
+        std::vector<SDL_FRect> dst;    // world space
+        bool quadsDirty = true;
+        b2BodyId body = b2_nullBodyId;
+    };
+
+    Chunk* chunkAt(int col, int row);
+    const Chunk* chunkAt(int col, int row) const;
+    void buildQuads(int chunkX, int chunkY, Chunk& chunk);
+    void buildChunkCollision(int chunkX, int chunkY, Chunk& chunk, float worldHeight);
+
+    int cols;
+    int rows;
+    int chunkCols;
+    int chunkRows;
+    float tileSize;
+    float originX;
+    float originY;
+    uint16_t depth;
+    std::vector<Chunk> chunks;      // chunkCols x chunkRows, row-major
+    std::vector<bool> nonSolid;     // indexed by tile, grown on demand
+
+    TextureHandle texture = INVALID_TEXTURE;
+    SDL_Rect sheetArea{0, 0, 0, 0};  // tile sheet inside its texture, followed when it is reloaded elsewhere
+    int sourceTileSize = 16;
+    int spacing = 0;
+    int sheetColumns = 1;
+
+    b2WorldId world = b2_nullWorldId;
+    int shapeCount = 0;
+};
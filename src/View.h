@@ -26,6 +26,12 @@ public:
         return screen;
     }
 
+    // Whether a screen-space rectangle overlaps the screen
+    bool isVisible(const SDL_Rect& screenRect) const {
+        return screenRect.x < screenWidth && screenRect.x + screenRect.w > 0 &&
+               screenRect.y < screenHeight && screenRect.y + screenRect.h > 0;
+    }
+
     // Center camera on a point (px, py), with optional clamping
     void centerOn(float px, float py) {
         x = px - screenWidth / 2.0f;
@@ -0,0 +1,79 @@
+#include "WorkerPool.h"
+#include <algorithm>
+
+WorkerPool::~WorkerPool() {
+    stop();
+}
+
+void WorkerPool::setWorkerCount(unsigned count) {
+    stop();
+    stopping = false;
+    for (unsigned i = 0; i < count; ++i) {
+        workers.emplace_back(&WorkerPool::run, this, i);
+    }
+}
+
+void WorkerPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+void WorkerPool::parallelFor(size_t count, size_t minChunk, const std::function<void(size_t, size_t)>& fn) {
+    if (count == 0) return;
+
+    // Slices for the workers plus one for the caller, none smaller than minChunk
+    size_t slices = std::min<size_t>(workers.size() + 1, std::max<size_t>(count / std::max<size_t>(minChunk, 1), 1));
+    if (slices <= 1) {
+        fn(0, count);
+        return;
+    }
+
+    size_t slice = (count + slices - 1) / slices;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &fn;
+        jobCount = count;
+        sliceSize = slice;
+        workerSlices = unsigned(slices - 1);
+        pending = workerSlices;
+        ++generation;
+    }
+    wake.notify_all();
+
+    // The caller takes the last slice
+    size_t callerBegin = std::min(slice * (slices - 1), count);
+    if (callerBegin < count) fn(callerBegin, count);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this]() { return pending == 0; });
+    job = nullptr;
+}
+
+void WorkerPool::run(unsigned index) {
+    unsigned seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [&]() { return stopping || generation != seen; });
+        if (stopping) return;
+        seen = generation;
+
+        // Workers beyond the slices handed out this time sit the job out
+        if (!job || index >= workerSlices) continue;
+        size_t begin = std::min(sliceSize * index, jobCount);
+        size_t end = std::min(begin + sliceSize, jobCount);
+        const std::function<void(size_t, size_t)>* fn = job;
+
+        lock.unlock();
+        if (begin < end) (*fn)(begin, end);
+        lock.lock();
+
+        if (--pending == 0) finished.notify_one();
+    }
+}
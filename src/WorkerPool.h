@@ -0,0 +1,49 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * WorkerPool - A few persistent threads for splitting a loop into chunks
+ *
+ * parallelFor() hands equal slices of [0, count) to the workers and the
+ * calling thread, and returns once every slice is done. With no workers (or a
+ * count below minChunk) the whole range simply runs on the caller.
+ */
+class WorkerPool {
+public:
+    WorkerPool() = default;
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Start (or restart with) this many worker threads; 0 stops them
+    void setWorkerCount(unsigned count);
+    unsigned getWorkerCount() const { return unsigned(workers.size()); }
+
+    /**
+     * Run job(begin, end) over [0, count) in parallel slices
+     * @param minChunk Smallest slice worth a thread
+     */
+    void parallelFor(size_t count, size_t minChunk, const std::function<void(size_t, size_t)>& job);
+
+private:
+    void run(unsigned index);
+    void stop();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;     // workers wait for a new job
+    std::condition_variable finished; // caller waits for the slices
+
+    const std::function<void(size_t, size_t)>* job = nullptr;
+    size_t jobCount = 0;
+    size_t sliceSize = 0;
+    unsigned generation = 0;   // bumped per job so workers run each one once
+    unsigned workerSlices = 0; // slices handed to workers for the current job
+    unsigned pending = 0;      // worker slices not yet finished
+    bool stopping = false;
+};
@@ -3,6 +3,8 @@
 #include "SpriteComponent.h" 
 #include "Engine.h"
 #include "ImageDevice.h"
+#include "AnimationLibrary.h"
+#include "AnimationStateMachine.h"
 #include "LevelLoader.h"
 #include "Menu.h"
 #include "InputDevice.h"
@@ -10,68 +12,178 @@
 #include <SDL.h>
 #include <iostream>
 
+// Longest an idle client sleeps in the event queue before checking again
+static const int IDLE_WAIT_MS = 500;
+// Main-thread time per frame spent turning background-decoded images into textures
+static const double ASSET_UPLOAD_BUDGET_MS = 4.0;
+
 int main(int argc, char* argv[])
 {
-    Engine e;
+    EngineConfig config = EngineConfig::fromArgs(argc, argv);
+    Engine e(config);
 
-    //  Load all textures
-    if (!ImageDevice::loadFromXML("assets/assets.xml")) {
+    // Textures are only registered here; each level makes its own set resident
+    if (!ImageDevice::registerFromXML("assets/assets.xml")) {
         std::cerr << "Failed to load assets.xml" << std::endl;
         return -1;
     }
+    AnimationLibrary::loadFromXML("assets/assets.xml");
+    AnimationStateMachine::loadFromXML("assets/assets.xml");
+    ParticleSystem::loadFromXML("assets/assets.xml");
+
+    // The first level's textures load in the background while the menu is up
+    e.prefetchLevelTextures("assets/level.xml");
 
     // Create menu
-    Menu menu(e.getRenderer(), e.getWidth(), e.getHeight());
+    Menu menu(e.getWidth(), e.getHeight());
     bool gameStarted = false;
     bool shouldQuit = false;
 
+    auto startGame = [&]() {
+        // Bodies and tile collision are built against the world height, so it is set first
+        e.setWorldSize(5000, 1200);
+        if (!LevelLoader::load("assets/level.xml", e)) {
+            std::cerr << "Failed to load level.xml" << std::endl;
+            return false;
+        }
+        gameStarted = true;
+        menu.setState(MenuState::IN_GAME);
+        return true;
+    };
+
+    // Nobody can click through the menu in headless mode
+    if (e.isHeadless() && !startGame()) {
+        return -1;
+    }
+
     // Main loop with menu
-    const int targetFPS = 60;
-    const int frameDelay = 1000 / targetFPS;
-    Uint32 lastTime = SDL_GetTicks();
+    FramePacer& pacer = e.getFramePacer();
+
+    // Throughput counters (printed when a frame limit is set)
+    int frameCount = 0;
+    Uint64 updateCounter = 0;
+    Uint64 renderCounter = 0;
+    Uint64 runStart = SDL_GetPerformanceCounter();
+
+    // Window state for idle mode: minimised windows draw nothing, unfocused ones stop simulating
+    bool minimized = false;
+    bool focused = true;
+    bool suspended = false;   // gameplay frozen because the window went to the background
+    bool pauseMenuActive = false;
+
+    auto handleEvent = [&](const SDL_Event& event) {
+        if (event.type == SDL_WINDOWEVENT) {
+            switch (event.window.event) {
+                case SDL_WINDOWEVENT_MINIMIZED: minimized = true; break;
+                case SDL_WINDOWEVENT_RESTORED:
+                case SDL_WINDOWEVENT_SHOWN: minimized = false; break;
+                case SDL_WINDOWEVENT_FOCUS_LOST: focused = false; break;
+                case SDL_WINDOWEVENT_FOCUS_GAINED: focused = true; break;
+                default: break;
+            }
+        }
+        if (event.type == SDL_QUIT) {
+            shouldQuit = true;
+        }
+        // Render target contents are lost on device resets
+        if (event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET) {
+            e.getStaticCache().onTargetsReset();
+        }
+        // A frozen frame is only redrawn when asked to
+        if (event.type == SDL_WINDOWEVENT &&
+            (event.window.event == SDL_WINDOWEVENT_EXPOSED || event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)) {
+            e.invalidateFrozenFrame();
+        }
+        // F1 toggles the physics debug overlay
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F1 && !event.key.repeat) {
+            e.getDebugDraw().toggle();
+        }
+        // F2 toggles the overdraw heatmap, F3 prints the last frame's render stats
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F2 && !event.key.repeat) {
+            e.setOverdrawHeatmap(!e.isOverdrawHeatmapEnabled());
+        }
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F3 && !event.key.repeat) {
+            RenderStats& stats = e.getRenderStats();
+            if (stats.isEnabled()) {
+                stats.print(std::cout);
+            } else {
+                stats.setEnabled(true);
+                std::cout << "RenderStats: Counting from the next frame, press F3 again to print" << std::endl;
+            }
+        }
+        // F4 prints resident textures and the memory they hold
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F4 && !event.key.repeat) {
+            ImageDevice::printMemory(std::cout);
+        }
+        // Handle try again button click if game is over
+        if (gameStarted && e.isGameOver() && event.type == SDL_MOUSEBUTTONDOWN) {
+            int mouseX = event.button.x;
+            int mouseY = event.button.y;
+            // Check if click is on "Try Again" button (center of screen)
+            if (mouseX >= e.getWidth() / 2 - 75 && mouseX <= e.getWidth() / 2 + 75 &&
+                mouseY >= e.getHeight() / 2 && mouseY <= e.getHeight() / 2 + 40) {
+                e.resetGame();
+            }
+        }
+        InputDevice::process(event);
+    };
+
+    // Set when the last frame presented nothing: the next one first sleeps in the event queue
+    bool idle = false;
 
     while (!shouldQuit)
     {
-        Uint32 frameStart = SDL_GetTicks();
-        float dt = (frameStart - lastTime) / 1000.0f;
-        if (dt > 0.1f) dt = 0.1f;
-        lastTime = frameStart;
+        // Idle: block until input, a window event or the safety timeout instead of running frames
+        SDL_Event event;
+        if (idle) {
+            if (SDL_WaitEventTimeout(&event, IDLE_WAIT_MS)) {
+                handleEvent(event);
+            }
+            // The time spent waiting is not a frame
+            pacer.resume();
+        }
+
+        pacer.beginFrame();
 
         // Process input events
-        SDL_Event event;
         while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                shouldQuit = true;
-            }
-            // Handle try again button click if game is over
-            if (gameStarted && e.isGameOver() && event.type == SDL_MOUSEBUTTONDOWN) {
-                int mouseX = event.button.x;
-                int mouseY = event.button.y;
-                // Check if click is on "Try Again" button (center of screen)
-                if (mouseX >= e.getWidth() / 2 - 75 && mouseX <= e.getWidth() / 2 + 75 &&
-                    mouseY >= e.getHeight() / 2 && mouseY <= e.getHeight() / 2 + 40) {
-                    e.resetGame();
-                }
-            }
-            InputDevice::process(event);
+            handleEvent(event);
         }
 
-        SDL_Renderer* renderer = e.getRenderer();
+        // Nothing to show while minimised
+        if (minimized && !e.isHeadless()) {
+            idle = true;
+            continue;
+        }
+
+        // Gameplay stops while the window is in the background (unless asked to keep running)
+        bool background = !focused && !config.runInBackground;
+        if (gameStarted && background && !suspended) {
+            e.freezeFrame();
+            suspended = true;
+        } else if (suspended && !background) {
+            if (!pauseMenuActive && !e.isGameOver()) e.unfreeze();
+            suspended = false;
+        }
 
         if (!gameStarted) {
+            // Nothing behind the main menu moves; it is only redrawn when it changes
+            e.freezeFrame();
+
+            if (ImageDevice::isLoading()) {
+                ImageDevice::updateAsyncLoads(ASSET_UPLOAD_BUDGET_MS);
+                menu.setLoadProgress(ImageDevice::getLoadProgress());
+            }
+
             // Show menu
             MenuAction action = menu.handleInput();
             
             switch (action) {
                 case MenuAction::START_GAME:
                     // Load game
-                    if (!LevelLoader::load("assets/level.xml", e)) {
-                        std::cerr << "Failed to load level.xml" << std::endl;
+                    if (!startGame()) {
                         return -1;
                     }
-                    e.setWorldSize(5000, 1200);
-                    gameStarted = true;
-                    menu.setState(MenuState::IN_GAME);
                     break;
                 case MenuAction::QUIT:
                     shouldQuit = true;
@@ -89,14 +201,16 @@ int main(int argc, char* argv[])
             // Toggle pause menu with ESC
             const Uint8* keystate = SDL_GetKeyboardState(NULL);
             static bool escPressed = false;
-            static bool pauseMenuActive = false;
 
             if (keystate[SDL_SCANCODE_ESCAPE] && !escPressed) {
                 pauseMenuActive = !pauseMenuActive;
                 if (pauseMenuActive) {
+                    // The game stays visible, frozen, under the pause menu
+                    e.freezeFrame();
                     menu.setState(MenuState::PAUSE_MENU);
                     menu.setSelectedIndex(0);
                 } else {
+                    e.unfreeze();
                     menu.setState(MenuState::IN_GAME);
                 }
                 escPressed = true;
@@ -104,7 +218,10 @@ int main(int argc, char* argv[])
                 escPressed = false;
             }
 
-            if (pauseMenuActive) {
+            if (suspended) {
+                // Frozen in the background: the overlay (if any) is all that is queued
+                if (e.isGameOver()) e.render();
+            } else if (pauseMenuActive) {
                 // Show pause menu and handle input
                 MenuAction action = menu.handleInput();
 
@@ -122,6 +239,8 @@ int main(int argc, char* argv[])
                             if (SaveGame::load(savePath, e)) {
                                 std::cout << "Game loaded!" << std::endl;
                                 pauseMenuActive = false;
+                                // The loaded game is live; SaveGame does not go through LevelLoader
+                                e.unfreeze();
                                 menu.setState(MenuState::IN_GAME);
                             }
                         } else {
@@ -131,6 +250,7 @@ int main(int argc, char* argv[])
                     }
                     case MenuAction::RESUME_GAME:
                         pauseMenuActive = false;
+                        e.unfreeze();
                         menu.setState(MenuState::IN_GAME);
                         break;
                     case MenuAction::QUIT:
@@ -143,87 +263,51 @@ int main(int argc, char* argv[])
                 menu.render();
             } else {
                 // Normal game update (only if not game over)
+                Uint64 updateStart = SDL_GetPerformanceCounter();
                 if (!e.isGameOver()) {
                     e.update();
                 }
+                Uint64 renderStart = SDL_GetPerformanceCounter();
+                updateCounter += renderStart - updateStart;
 
-                View& view = e.getView();
-
-                SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-                SDL_RenderClear(renderer);
-
-                // render all sprites
-                for(auto& objPtr : e.getObjects())
-                {
-                    Object* obj = objPtr.get();
-                    obj->render();
-                }
+                // queue the world, HUD and overlays; drawn when the frame is presented
+                e.render();
+                renderCounter += SDL_GetPerformanceCounter() - renderStart;
+            }
+        }
 
-                //  draw debug boxes on top
-                for(auto& objPtr : e.getObjects())
-                {
-                    Object* obj = objPtr.get();
-                    if(auto* body = obj->getComponent<BodyComponent>())
-                    {
-                        // For player, adjust collision box to match actual sprite size
-                        SDL_Rect rect;
-                        if(obj == e.getPlayer()) {
-                            float px = body->getX();
-                            float py = body->getY();
-                            float pw = body->getWidth();
-                            float ph = body->getHeight();
-                            
-                            // Reduce collision box size to match visible sprite (account for transparent padding)
-                            // The sprite is 64x64 but has ~10px of transparent padding on each side
-                            const float spritePadding = 10.0f;
-                            float visibleWidth = pw - (spritePadding * 2.0f);
-                            float visibleHeight = ph - (spritePadding * 2.0f);
-                            
-                            // Create rect with adjusted size to match visible sprite
-                            SDL_Rect worldRect = {
-                                int(px - visibleWidth / 2.0f),
-                                int(py - visibleHeight / 2.0f),
-                                int(visibleWidth),
-                                int(visibleHeight)
-                            };
-                            rect = view.transform(worldRect);
-                        } else {
-                            rect = view.transform(body->getRect());
-                        }
+        // Draws the queued frame (on the render thread, the next frame is simulated meanwhile)
+        Uint64 presentStart = SDL_GetPerformanceCounter();
+        bool presented = e.presentFrame();
+        renderCounter += SDL_GetPerformanceCounter() - presentStart;
 
-                        if(obj == e.getPlayer())
-                        {
-                            SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-                        } 
-                        else if(obj->getComponent<GroundComponent>())
-                        {
-                            SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-                        }
-                        else 
-                        {
-                            SDL_SetRenderDrawColor(renderer, 0, 0, 255, 255);
-                        }
+        // Waits for the next frame in fixed mode; vsync and uncapped return at once.
+        // Unchanged frozen frames present nothing: windowed runs then wait for events,
+        // headless ones (nothing to wait for) sleep out the frame. Pending uploads keep it awake
+        idle = !presented && !e.isHeadless() && !ImageDevice::isLoading();
+        if (!idle) pacer.endFrame(!presented);
 
-                        SDL_RenderDrawRect(renderer, &rect);
-                    }
-                }
-                
-                // Render health UI and game over screen (handled in Engine::render)
-                // But we need to call it here since main.cpp has its own render loop
-                e.renderHealthUI();
-                if (e.isGameOver()) {
-                    e.renderGameOver();
-                }
-            }
+        ++frameCount;
+        if (config.frames > 0 && frameCount >= config.frames) {
+            shouldQuit = true;
         }
+    }
 
-        SDL_RenderPresent(renderer);
-
-        Uint32 frameTime = SDL_GetTicks() - frameStart;
-        if(frameDelay > frameTime)
-            SDL_Delay(frameDelay - frameTime);
+    if (config.frames > 0) {
+        double freq = double(SDL_GetPerformanceFrequency());
+        double total = (SDL_GetPerformanceCounter() - runStart) / freq;
+        std::cout << "Run: " << frameCount << " frames in " << total << " s ("
+                  << (total > 0.0 ? frameCount / total : 0.0) << " fps)"
+                  << " | update " << (updateCounter / freq) * 1000.0 / frameCount << " ms/frame"
+                  << " | render " << (renderCounter / freq) * 1000.0 / frameCount << " ms/frame"
+                  << " | world scale " << e.getRenderScale() << std::endl;
 
-        lastTime = SDL_GetTicks();
+        FrameStats stats = pacer.getStats();
+        std::cout << "Frame times (last " << FramePacer::STATS_WINDOW << ", " << FramePacer::modeName(pacer.getMode())
+                  << "): avg " << stats.averageMs << " ms, min " << stats.minMs << " ms, max " << stats.maxMs << " ms" << std::endl;
+        if (e.getRenderStats().isEnabled()) {
+            e.getRenderStats().print(std::cout);
+        }
     }
     return 0;
 }
\ No newline at end of file